@@ -0,0 +1,78 @@
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "inibin.h"
+#include "paths.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+struct Totals {
+    size_t files = 0;
+    uintmax_t before = 0;
+    uintmax_t after = 0;
+};
+
+int bake_file(fs::path const& in, fs::path const& out, bool bake, Totals& totals) noexcept {
+    Ini ini{};
+    if(auto r = ini.from_file(in.string().c_str()); r) {
+        fprintf(stderr, "failed to read %s: %d\n", in.string().c_str(), r);
+        return r;
+    }
+    if(auto r = ini.to_file(out.string().c_str(), bake); r) {
+        fprintf(stderr, "failed to write %s: %d\n", out.string().c_str(), r);
+        return r;
+    }
+    std::error_code ec;
+    totals.files++;
+    totals.before += fs::file_size(in, ec);
+    totals.after += fs::file_size(out, ec);
+    return 0;
+}
+}
+
+int main(int argc, char** argv) {
+    bool bake = false;
+    if(argc > 1 && std::string(argv[1]) == "-b") {
+        bake = true;
+        argv++;
+        argc--;
+    }
+    if(argc < 3) {
+        fprintf(stderr, "usage: %s [-b] <in.troybin|dir> <out.troybin|dir>\n", argv[0]);
+        return 1;
+    }
+    fs::path const in = argv[1];
+    fs::path const out = argv[2];
+    Totals totals{};
+    int failed = 0;
+    std::error_code ec;
+    if(fs::is_directory(in, ec)) {
+        ec = for_each_file(in, [&](fs::path const& path) {
+            if(!is_troybin(path)) {
+                return;
+            }
+            std::error_code path_ec;
+            auto const target = out / fs::relative(path, in, path_ec);
+            if(path_ec) {
+                fprintf(stderr, "failed to resolve %s\n", path.string().c_str());
+                failed++;
+                return;
+            }
+            fs::create_directories(target.parent_path(), path_ec);
+            if(bake_file(path, target, bake, totals)) {
+                failed++;
+            }
+        });
+        if(ec) {
+            fprintf(stderr, "failed to list: %s\n", argv[1]);
+            return 1;
+        }
+    } else if(bake_file(in, out, bake, totals)) {
+        failed++;
+    }
+    printf("%s %zu files, %ju -> %ju bytes\n", bake ? "baked" : "rewrote",
+           totals.files, totals.before, totals.after);
+    return failed ? 1 : 0;
+}
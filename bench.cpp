@@ -0,0 +1,246 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "file.hpp"
+#include "flatmap.hpp"
+#include "inibin.h"
+#include "particle/system.h"
+#include "ritoskn.hpp"
+#include "ritonvr.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+struct Corpus {
+    std::vector<std::string> troybins;
+    std::vector<std::string> skns;
+    std::vector<std::string> nvrs;
+    uint64_t bytes = 0;
+};
+
+std::string lower_extension(fs::path const& path) {
+    auto ext = path.extension().string();
+    for(auto& c: ext) {
+        c = static_cast<char>(c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c);
+    }
+    return ext;
+}
+
+int list(fs::path const& root, Corpus& corpus) noexcept {
+    std::error_code ec;
+    // increment(ec) instead of operator++, which throws
+    for(fs::recursive_directory_iterator it(root, ec), end; !ec && it != end; it.increment(ec)) {
+        auto const regular = it->is_regular_file(ec);
+        if(ec) {
+            break;
+        }
+        if(!regular) {
+            continue;
+        }
+        auto const ext = lower_extension(it->path());
+        auto* out = ext == ".troybin" ? &corpus.troybins
+                    : ext == ".skn" ? &corpus.skns
+                    : ext == ".nvr" ? &corpus.nvrs
+                    : nullptr;
+        if(!out) {
+            continue;
+        }
+        auto const size = it->file_size(ec);
+        if(ec) {
+            break;
+        }
+        corpus.bytes += size;
+        out->push_back(it->path().string());
+    }
+    return ec ? -1 : 0;
+}
+
+// Runs load over every path rounds times, the first untimed round warms the page cache
+template<typename Load>
+void run(char const* name, std::vector<std::string> const& paths, size_t rounds, Load&& load) {
+    if(paths.empty()) {
+        return;
+    }
+    size_t failed = 0;
+    for(auto const& path: paths) {
+        failed += load(path.c_str()) ? 1 : 0;
+    }
+    auto const beg = Clock::now();
+    for(size_t r = 0; r < rounds; r++) {
+        for(auto const& path: paths) {
+            load(path.c_str());
+        }
+    }
+    auto const us = std::chrono::duration<double, std::micro>(Clock::now() - beg).count();
+    printf("%-28s %6zu files %8.2f ms/round %8.2f us/file",
+           name, paths.size(), us / 1000.0 / rounds, us / (rounds * paths.size()));
+    if(failed) {
+        printf(" (%zu failed)", failed);
+    }
+    printf("\n");
+}
+
+// Same loader through a per-field fread, the read-ahead window and a mapping
+template<typename Asset>
+void run_loader(char const* name, std::vector<std::string> const& paths, size_t rounds) {
+    std::string label;
+    label = std::string(name) + " stdio direct";
+    run(label.c_str(), paths, rounds, [](char const* path) {
+        auto const file = StdioFile::readb(path, 0);
+        Asset asset{};
+        return !file || asset.load(*file);
+    });
+    label = std::string(name) + " stdio window";
+    run(label.c_str(), paths, rounds, [](char const* path) {
+        auto const file = StdioFile::readb(path);
+        Asset asset{};
+        return !file || asset.load(*file);
+    });
+    label = std::string(name) + " mapped";
+    run(label.c_str(), paths, rounds, [](char const* path) {
+        auto const file = MemoryFile::mapb(path);
+        Asset asset{};
+        return !file || asset.load(*file);
+    });
+}
+
+// Ini only loads from a whole buffer or through from_file, which reads
+// through the window
+void run_ini(std::vector<std::string> const& paths, size_t rounds) {
+    run("troybin from_file window", paths, rounds, [](char const* path) {
+        Ini ini{};
+        return ini.from_file(path) != 0;
+    });
+    run("troybin stdio whole", paths, rounds, [](char const* path) {
+        auto const file = StdioFile::readb(path, 0);
+        std::vector<uint8_t> data;
+        Ini ini{};
+        return !file || !file->read(data, file->end)
+                || ini.from_memory(data.data(), data.size());
+    });
+    run("troybin mapped", paths, rounds, [](char const* path) {
+        auto const file = MemoryFile::mapb(path);
+        Ini ini{};
+        return !file || ini.from_memory(file->map, file->end);
+    });
+}
+
+int bench_read(Corpus const& corpus, size_t rounds) noexcept {
+    run_ini(corpus.troybins, rounds);
+    run_loader<RitoSKN>("skn", corpus.skns, rounds);
+    run_loader<RitoNVR>("nvr", corpus.nvrs, rounds);
+    return 0;
+}
+
+// Sum of the found values so the lookups can't be dropped
+template<typename Map>
+uint64_t probe(Map const& map, std::vector<uint32_t> const& keys) noexcept {
+    uint64_t sum = 0;
+    for(auto const k: keys) {
+        if(auto const i = map.find(k); i != map.end()) {
+            sum += i->second;
+        }
+    }
+    return sum;
+}
+
+// Lookups of System::load, mostly SimpleEmitter::load, then the same
+// number of lookups with the same miss ratio against FlatMap and
+// std::unordered_map holding the keys of each file
+int bench_ini(Corpus const& corpus, size_t rounds) {
+    std::vector<Ini> inis(corpus.troybins.size());
+    for(size_t i = 0; i < inis.size(); i++) {
+        if(auto r = inis[i].from_file(corpus.troybins[i].c_str()); r) {
+            fprintf(stderr, "failed to read %s: %d\n", corpus.troybins[i].c_str(), r);
+            return 1;
+        }
+        inis[i].enable_lookup_stats();
+    }
+    if(inis.empty()) {
+        return 0;
+    }
+
+    uint64_t lookups = 0;
+    uint64_t misses = 0;
+    auto const beg = Clock::now();
+    for(size_t r = 0; r < rounds; r++) {
+        for(auto& ini: inis) {
+            ini.reset_lookup_stats();
+            RitoParticle::System system{};
+            system.load(ini);
+            auto const stats = ini.lookup_stats();
+            lookups += stats.lookups;
+            misses += stats.rejected + stats.false_positives;
+        }
+    }
+    auto const us = std::chrono::duration<double, std::micro>(Clock::now() - beg).count();
+    auto const miss_ratio = lookups ? static_cast<double>(misses) / lookups : 0.0;
+    auto const per_file = static_cast<size_t>(lookups / (rounds * inis.size()));
+    printf("System::load %8.2f ms/round %8.0f lookups/file %5.1f%% misses %8.2f M lookups/s\n",
+           us / 1000.0 / rounds, static_cast<double>(lookups) / (rounds * inis.size()),
+           miss_ratio * 100.0, lookups / us);
+
+    std::mt19937 rng(1);
+    std::vector<FlatMap<uint32_t, uint32_t>> flat(inis.size());
+    std::vector<std::unordered_map<uint32_t, uint32_t>> node(inis.size());
+    std::vector<std::vector<uint32_t>> queries(inis.size());
+    std::vector<uint32_t> hashes;
+    for(size_t i = 0; i < inis.size(); i++) {
+        hashes.clear();
+        inis[i].hashes(hashes);
+        for(auto const h: hashes) {
+            flat[i].try_emplace(h, h);
+            node[i].try_emplace(h, h);
+        }
+        for(size_t q = 0; q < per_file; q++) {
+            auto k = static_cast<uint32_t>(rng());
+            if(!hashes.empty() && std::uniform_real_distribution<double>()(rng) >= miss_ratio) {
+                k = hashes[rng() % hashes.size()];
+            }
+            queries[i].push_back(k);
+        }
+    }
+    auto const time_map = [&](char const* name, auto const& maps) {
+        uint64_t sum = 0;
+        auto const beg = Clock::now();
+        for(size_t r = 0; r < rounds; r++) {
+            for(size_t i = 0; i < maps.size(); i++) {
+                sum += probe(maps[i], queries[i]);
+            }
+        }
+        auto const ns = std::chrono::duration<double, std::nano>(Clock::now() - beg).count();
+        printf("%-28s %8.2f ns/lookup (%llu)\n", name,
+               ns / std::max<size_t>(1, rounds * per_file * maps.size()),
+               static_cast<unsigned long long>(sum));
+    };
+    time_map("FlatMap find", flat);
+    time_map("std::unordered_map find", node);
+    return 0;
+}
+}
+
+int main(int argc, char** argv) {
+    std::string const mode = argc > 1 ? argv[1] : "";
+    if(argc < 3 || (mode != "read" && mode != "ini")) {
+        fprintf(stderr, "usage: %s read|ini <asset dir> [rounds]\n", argv[0]);
+        return 1;
+    }
+    size_t const rounds = argc > 3 ? std::max(1, atoi(argv[3])) : 10;
+    Corpus corpus;
+    if(list(argv[2], corpus)) {
+        fprintf(stderr, "failed to list: %s\n", argv[2]);
+        return 1;
+    }
+    printf("%zu troybin %zu skn %zu nvr, %.2f MB, %zu rounds\n",
+           corpus.troybins.size(), corpus.skns.size(), corpus.nvrs.size(),
+           corpus.bytes / (1024.0 * 1024.0), rounds);
+    return mode == "read" ? bench_read(corpus, rounds) : bench_ini(corpus, rounds);
+}
@@ -0,0 +1,70 @@
+#ifndef BLOOM_HPP
+#define BLOOM_HPP
+#include <cstdint>
+#include <vector>
+
+// Blocked bloom filter over 32-bit hashes, each key sets 3 bits in a single
+// 64-bit word so a query touches one cache line.
+// Answers "definitely absent" or "maybe present", erase is not supported.
+class PresenceFilter {
+private:
+    // ~8 bits per key keeps false positives around 4%
+    inline constexpr static size_t bits_per_key = 8;
+
+    std::vector<uint64_t> words;
+    uint32_t shift = 64;
+    size_t capacity_ = 0;
+
+    inline static uint64_t mix(uint32_t key) noexcept {
+        return key * 0x9E3779B97F4A7C15ull;
+    }
+
+    inline size_t word(uint64_t x) const noexcept {
+        return shift == 64 ? 0 : static_cast<size_t>(x >> shift);
+    }
+
+    inline static uint64_t mask(uint64_t x) noexcept {
+        return (uint64_t{1} << ((x >> 20) & 63))
+                | (uint64_t{1} << ((x >> 26) & 63))
+                | (uint64_t{1} << ((x >> 32) & 63));
+    }
+public:
+    // keys that fit before the false positive rate goes up
+    inline size_t capacity() const noexcept { return capacity_; }
+
+    inline bool empty() const noexcept { return words.empty(); }
+
+    inline void clear() noexcept {
+        words.clear();
+        shift = 64;
+        capacity_ = 0;
+    }
+
+    // Drops all keys and sizes the filter for count keys
+    inline void reset(size_t count) {
+        uint32_t bits = 0;
+        while((size_t{64} << bits) < count * bits_per_key) {
+            bits++;
+        }
+        words.assign(size_t{1} << bits, 0);
+        shift = 64 - bits;
+        capacity_ = (words.size() * 64) / bits_per_key;
+    }
+
+    inline void insert(uint32_t key) noexcept {
+        auto const x = mix(key);
+        words[word(x)] |= mask(x);
+    }
+
+    // Always true while empty, a filter that was never built rejects nothing
+    inline bool maybe_contains(uint32_t key) const noexcept {
+        if(words.empty()) {
+            return true;
+        }
+        auto const x = mix(key);
+        auto const m = mask(x);
+        return (words[word(x)] & m) == m;
+    }
+};
+
+#endif // BLOOM_HPP
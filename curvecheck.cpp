@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <vector>
+#include "particle/ptypes.h"
+
+using namespace RitoParticle;
+
+namespace {
+// Curves like the ones in troybins plus the edge cases: duplicate key
+// times, keys out of order, times on the keys, outside [0, 1] and NaN
+struct Case {
+    std::vector<TimeValue<float>> keys;
+    float base;
+    std::vector<float> times;
+};
+
+Case make_case(std::mt19937& rng) {
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::uniform_real_distribution<float> value(-10.0f, 10.0f);
+    Case result;
+    auto const count = rng() % 9;
+    for(size_t k = 0; k < count; k++) {
+        // a few repeated times so segments of zero length show up
+        auto const time = !result.keys.empty() && rng() % 5 == 0
+                ? result.keys.back().time
+                : unit(rng);
+        result.keys.push_back({ time, value(rng) });
+    }
+    if(rng() % 4) {
+        std::sort(result.keys.begin(), result.keys.end(), [](auto const& l, auto const& r) {
+            return l.time < r.time;
+        });
+    }
+    result.base = rng() % 3 ? 1.0f : value(rng);
+    auto const times = rng() % 70;
+    for(size_t i = 0; i < times; i++) {
+        switch(rng() % 8) {
+        case 0:
+            result.times.push_back(std::numeric_limits<float>::quiet_NaN());
+            break;
+        case 1:
+            result.times.push_back(result.keys.empty() ? 0.0f : result.keys[rng() % result.keys.size()].time);
+            break;
+        case 2:
+            result.times.push_back(value(rng));
+            break;
+        case 3:
+            result.times.push_back(rng() % 2 ? std::numeric_limits<float>::infinity()
+                                             : -std::numeric_limits<float>::infinity());
+            break;
+        default:
+            result.times.push_back(unit(rng));
+            break;
+        }
+    }
+    return result;
+}
+}
+
+// Runs EvalTimeValuesBatch against EvalTimeValues, results must be equal
+// or both NaN. Returns 1 and prints the first mismatches otherwise.
+int main(int argc, char** argv) {
+    size_t const cases = argc > 1 ? strtoul(argv[1], nullptr, 10) : 100000;
+    std::mt19937 rng(1);
+    size_t checked = 0;
+    size_t failed = 0;
+    std::vector<float> out;
+    for(size_t c = 0; c < cases; c++) {
+        auto const test = make_case(rng);
+        out.assign(test.times.size(), 0.0f);
+        EvalTimeValuesBatch(test.keys, test.base, test.times.data(), test.times.size(), out.data());
+        for(size_t i = 0; i < test.times.size(); i++) {
+            auto const expected = EvalTimeValues(test.keys, test.base, test.times[i]);
+            checked++;
+            if(out[i] == expected || (std::isnan(out[i]) && std::isnan(expected))) {
+                continue;
+            }
+            if(failed++ < 10) {
+                fprintf(stderr, "case %zu: %zu keys, time %g gives %g instead of %g\n",
+                        c, test.keys.size(), test.times[i], out[i], expected);
+            }
+        }
+    }
+    printf("%zu of %zu times differ\n", failed, checked);
+    return failed ? 1 : 0;
+}
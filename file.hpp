@@ -1,75 +1,441 @@
 #pragma once
 #include <cstdio>
+#include <cstring>
+#include <cstdint>
 #include <vector>
 #include <optional>
+#include <algorithm>
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Read only view into file memory, only valid as long as the File lives
+template<typename T>
+struct Span {
+    T const* ptr = nullptr;
+    size_t count = 0;
+
+    inline T const* data() const noexcept { return ptr; }
+    inline size_t size() const noexcept { return count; }
+    inline bool empty() const noexcept { return count == 0; }
+    inline T const* begin() const noexcept { return ptr; }
+    inline T const* end() const noexcept { return ptr + count; }
+    inline T const& operator[](size_t idx) const noexcept { return ptr[idx]; }
+};
+
+// Span that views file memory in place or owns a copy in storage,
+// copies of an owning array point at their own storage
+template<typename T>
+struct FileArray : Span<T> {
+    std::vector<T> storage = {};
+
+    FileArray() noexcept = default;
+    FileArray(FileArray const& other)
+        : Span<T>(other), storage(other.storage) {
+        rebind(other);
+    }
+    FileArray(FileArray && other) noexcept
+        : Span<T>(other), storage(std::move(other.storage)) {
+        other.ptr = nullptr;
+        other.count = 0;
+    }
+    FileArray& operator=(FileArray const& other) {
+        if(this != &other) {
+            Span<T>::operator=(other);
+            storage = other.storage;
+            rebind(other);
+        }
+        return *this;
+    }
+    FileArray& operator=(FileArray && other) noexcept {
+        if(this != &other) {
+            Span<T>::operator=(other);
+            storage = std::move(other.storage);
+            other.ptr = nullptr;
+            other.count = 0;
+        }
+        return *this;
+    }
+
+    // Takes ownership of data
+    inline void assign(std::vector<T>&& data) noexcept {
+        storage = std::move(data);
+        this->ptr = storage.data();
+        this->count = storage.size();
+    }
+
+private:
+    inline void rebind(FileArray const& other) noexcept {
+        if(!other.storage.empty() && other.ptr == other.storage.data()) {
+            this->ptr = storage.data();
+        }
+    }
+};
+
+template<typename Source>
+struct BasicFile;
+
+// fseek and ftell take a long, which is 32 bit on Windows
+inline int seek64(FILE* f, uint64_t pos, int origin = SEEK_SET) noexcept {
+#ifdef _WIN32
+    return _fseeki64(f, static_cast<int64_t>(pos), origin);
+#else
+    return fseeko(f, static_cast<off_t>(pos), origin);
+#endif
+}
+
+inline int64_t tell64(FILE* f) noexcept {
+#ifdef _WIN32
+    return _ftelli64(f);
+#else
+    return static_cast<int64_t>(ftello(f));
+#endif
+}
+
+// FILE* backed source with a read-ahead window
+struct StdioSource {
+    inline constexpr static bool in_memory = false;
+    inline constexpr static size_t default_window = 64 * 1024;
 
-struct File {
     FILE* file;
     size_t end;
+    mutable size_t pos;
+    // 0 reads straight through
+    size_t window;
+    mutable std::vector<uint8_t> buffer;
+    mutable size_t buffer_beg;
+    mutable size_t file_pos;
 
-    inline File(FILE* file) noexcept : file(file), end(0) {
-        end = static_cast<size_t>(fseek(file, 0, SEEK_END));
-        fseek(file, 0, SEEK_SET);
+    inline StdioSource(FILE* file, size_t window = default_window) noexcept
+        : file(file), end(0), pos(0),
+          window(window), buffer(), buffer_beg(0), file_pos(0) {
+        if(!seek64(file, 0, SEEK_END)) {
+            auto const size = tell64(file);
+            end = size > 0 ? static_cast<size_t>(size) : 0;
+        }
+        seek64(file, 0);
+        if(window) {
+            // we do our own buffering, avoid copying through stdio's
+            setvbuf(file, nullptr, _IONBF, 0);
+        }
     }
-    File(File && other) noexcept : file(other.file), end(other.end) {
+    StdioSource(StdioSource && other) noexcept
+        : file(other.file), end(other.end), pos(other.pos),
+          window(other.window), buffer(std::move(other.buffer)),
+          buffer_beg(other.buffer_beg), file_pos(other.file_pos) {
         other.file = nullptr;
         other.end = 0;
+        other.pos = 0;
+        other.buffer.clear();
     }
-    inline ~File() noexcept {
+    inline ~StdioSource() noexcept {
         if(file) {
             fclose(file);
         }
     }
-    File(File const&) = delete;
-    void operator=(File const&) = delete;
-    void operator=(File &&) = delete;
+    StdioSource(StdioSource const&) = delete;
+    void operator=(StdioSource const&) = delete;
+    void operator=(StdioSource &&) = delete;
 
-    static std::optional<File> readb(char const* name) noexcept {
-        if(FILE* f = nullptr; fopen_s(&f, name, "rb") || !f) {
-            return std::nullopt;
-        } else {
-            return File(f);
+    static std::optional<BasicFile<StdioSource>> readb(char const* name,
+                                                       size_t window = default_window) noexcept;
+
+    // Reads size bytes at pos straight from the FILE*
+    inline bool read_direct(void* data, size_t size) const noexcept {
+        if(file_pos != pos) {
+            if(seek64(file, pos)) {
+                return false;
+            }
+            file_pos = pos;
+        }
+        auto const result = fread(data, 1, size, file);
+        file_pos += result;
+        return result == size;
+    }
+
+    // Returns pointer to size contiguous bytes at pos and advances past them,
+    // nullptr when out of bounds or size does not fit in the read-ahead window
+    inline uint8_t const* fetch(size_t size) const noexcept {
+        if(size > end - pos) {
+            return nullptr;
+        }
+        if(pos < buffer_beg || pos + size > buffer_beg + buffer.size()) {
+            if(size > window) {
+                return nullptr;
+            }
+            buffer.resize(std::min(window, end - pos));
+            if(!read_direct(buffer.data(), buffer.size())) {
+                buffer.clear();
+                return nullptr;
+            }
+            buffer_beg = pos;
+        }
+        auto const result = buffer.data() + (pos - buffer_beg);
+        pos += size;
+        return result;
+    }
+
+    inline bool read_bytes(void* data, size_t size) const noexcept {
+        if(size <= window) {
+            if(auto const src = fetch(size); src) {
+                memcpy(data, src, size);
+                return true;
+            }
+            return false;
+        }
+        // too big for the window, don't bother buffering
+        if(size > end - pos || !read_direct(data, size)) {
+            return false;
+        }
+        pos += size;
+        return true;
+    }
+};
+
+// Memory backed source, either a file mapping or caller owned memory
+struct MemorySource {
+    inline constexpr static bool in_memory = true;
+
+    uint8_t const* map;
+    size_t end;
+    mutable size_t pos;
+    // unmapped on destruction
+    bool mapped;
+
+    inline MemorySource(uint8_t const* map, size_t size, bool mapped = false) noexcept
+        : map(map), end(size), pos(0), mapped(mapped) {}
+    MemorySource(MemorySource && other) noexcept
+        : map(other.map), end(other.end), pos(other.pos), mapped(other.mapped) {
+        other.map = nullptr;
+        other.end = 0;
+        other.pos = 0;
+        other.mapped = false;
+    }
+    inline ~MemorySource() noexcept {
+        if(mapped) {
+#ifdef _WIN32
+            UnmapViewOfFile(map);
+#else
+            munmap(const_cast<uint8_t*>(map), end);
+#endif
+        }
+    }
+    MemorySource(MemorySource const&) = delete;
+    void operator=(MemorySource const&) = delete;
+    void operator=(MemorySource &&) = delete;
+
+    // Maps whole file into memory
+    static std::optional<BasicFile<MemorySource>> mapb(char const* name) noexcept;
+
+    // Wraps caller owned memory, data must outlive the File
+    static BasicFile<MemorySource> from_memory(uint8_t const* data, size_t size) noexcept;
+
+    inline uint8_t const* fetch(size_t size) const noexcept {
+        if(size > end - pos) {
+            return nullptr;
+        }
+        auto const result = map + pos;
+        pos += size;
+        return result;
+    }
+
+    inline bool read_bytes(void* data, size_t size) const noexcept {
+        if(auto const src = fetch(size); src) {
+            memcpy(data, src, size);
+            return true;
         }
+        return false;
     }
+};
+
+// Typed reads on top of a byte source, loaders take any BasicFile as template
+template<typename Source>
+struct BasicFile : Source {
+    using Source::Source;
 
     inline int64_t tell() const noexcept {
-        return ftell(file);
+        return static_cast<int64_t>(this->pos);
     }
 
     inline int64_t seek_beg(int64_t offset) const noexcept {
-        return fseek(file, static_cast<long int>(offset), SEEK_SET);
+        if(offset < 0 || static_cast<size_t>(offset) > this->end) {
+            return -1;
+        }
+        this->pos = static_cast<size_t>(offset);
+        return 0;
     }
 
     inline int64_t seek_cur(int64_t offset) const noexcept {
-        return fseek(file, static_cast<long int>(offset), SEEK_CUR);
+        return seek_beg(static_cast<int64_t>(this->pos) + offset);
     }
 
     inline int64_t seek_end(int64_t offset) const noexcept {
-        return fseek(file, static_cast<long int>(offset), SEEK_END);
+        return seek_beg(static_cast<int64_t>(this->end) + offset);
     }
 
     template<typename T>
     inline bool read(T* data, size_t count) const noexcept {
-        if(auto const result = fread(data, sizeof(T), count, file);
-                result != count) {
+        if(count > (this->end - this->pos) / sizeof(T)) {
             return false;
         }
-        return true;
+        if(count == 0) {
+            return true;
+        }
+        return this->read_bytes(data, count * sizeof(T));
     }
 
     template<typename T>
     inline bool read(std::vector<T>& value, size_t count) const noexcept {
-        auto const cur = static_cast<size_t>(ftell(file));
-        auto const vec_size = count * sizeof(T);
-        if(vec_size > (end - cur)) {
+        if(count > (this->end - this->pos) / sizeof(T)) {
             return false;
         }
         value.resize(count);
-        return read(&value[0], count);
+        return read(value.data(), count);
     }
 
     template<typename T>
     inline bool read(T& value) const noexcept {
         return read(&value, 1);
     }
+
+    // Reads consecutive fields with a single bounds check and buffer lookup
+    template<typename...T>
+    inline bool read_struct_batch(T&...values) const noexcept {
+        constexpr size_t size = (sizeof(T) + ...);
+        auto const start = this->pos;
+        auto src = this->fetch(size);
+        if(!src) {
+            this->pos = start;
+            return (read(values) && ...);
+        }
+        ((memcpy(&values, src, sizeof(T)), src += sizeof(T)), ...);
+        return true;
+    }
+
+    // References count elements in place, fails on FILE* backed or misaligned data
+    template<typename T>
+    inline bool view(Span<T>& value, size_t count) const noexcept {
+        if constexpr(Source::in_memory) {
+            if(count > (this->end - this->pos) / sizeof(T)) {
+                return false;
+            }
+            auto const ptr = this->map + this->pos;
+            if(reinterpret_cast<uintptr_t>(ptr) % alignof(T)) {
+                return false;
+            }
+            value = { reinterpret_cast<T const*>(ptr), count };
+            this->pos += count * sizeof(T);
+            return true;
+        } else {
+            return false;
+        }
+    }
+
+    // Views in place when possible, otherwise copies into storage
+    template<typename T>
+    inline bool read_view(Span<T>& value, std::vector<T>& storage,
+                          size_t count) const noexcept {
+        if(view(value, count)) {
+            return true;
+        }
+        if(!read(storage, count)) {
+            return false;
+        }
+        value = { storage.data(), storage.size() };
+        return true;
+    }
+
+    // Views in place when asked to and possible, otherwise copies into the array
+    template<typename T>
+    inline bool read(FileArray<T>& value, size_t count, bool in_place) const noexcept {
+        value.storage.clear();
+        if(in_place && view(value, count)) {
+            return true;
+        }
+        if(!read(value.storage, count)) {
+            return false;
+        }
+        value.ptr = value.storage.data();
+        value.count = value.storage.size();
+        return true;
+    }
 };
+
+using StdioFile = BasicFile<StdioSource>;
+using MemoryFile = BasicFile<MemorySource>;
+
+inline std::optional<StdioFile> StdioSource::readb(char const* name, size_t window) noexcept {
+    if(FILE* f = nullptr; fopen_s(&f, name, "rb") || !f) {
+        return std::nullopt;
+    } else {
+        return StdioFile(f, window);
+    }
+}
+
+inline MemoryFile MemorySource::from_memory(uint8_t const* data, size_t size) noexcept {
+    return MemoryFile(data, size, false);
+}
+
+inline std::optional<MemoryFile> MemorySource::mapb(char const* name) noexcept {
+    static uint8_t const empty[1] = {};
+#ifdef _WIN32
+    HANDLE const f = CreateFileA(name, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                 OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if(f == INVALID_HANDLE_VALUE) {
+        return std::nullopt;
+    }
+    LARGE_INTEGER size = {};
+    if(!GetFileSizeEx(f, &size)) {
+        CloseHandle(f);
+        return std::nullopt;
+    }
+    if(size.QuadPart == 0) {
+        CloseHandle(f);
+        return MemoryFile(empty, 0, false);
+    }
+    HANDLE const m = CreateFileMappingA(f, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(f);
+    if(!m) {
+        return std::nullopt;
+    }
+    void const* data = MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(m);
+    if(!data) {
+        return std::nullopt;
+    }
+    return MemoryFile(static_cast<uint8_t const*>(data),
+                      static_cast<size_t>(size.QuadPart), true);
+#else
+    int const fd = open(name, O_RDONLY);
+    if(fd < 0) {
+        return std::nullopt;
+    }
+    struct stat st = {};
+    if(fstat(fd, &st) != 0) {
+        close(fd);
+        return std::nullopt;
+    }
+    if(st.st_size == 0) {
+        close(fd);
+        return MemoryFile(empty, 0, false);
+    }
+    auto const size = static_cast<size_t>(st.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(data == MAP_FAILED) {
+        return std::nullopt;
+    }
+    return MemoryFile(static_cast<uint8_t const*>(data), size, true);
+#endif
+}
@@ -0,0 +1,211 @@
+#ifndef FLATMAP_HPP
+#define FLATMAP_HPP
+#include <cstdint>
+#include <vector>
+#include <utility>
+#include <tuple>
+#include <new>
+#include <algorithm>
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+// Open addressing hash map for keys that already are 32-bit hashes.
+// Entries live in a dense vector, the probe table only holds key + index
+// so a lookup touches a single cache line in the common case.
+// Iterators and references are invalidated by insert and erase.
+// Kept for memory rather than lookup speed, which is on par with
+// std::unordered_map: on real troybins (9 to 113 keys) it takes 26-32 heap
+// bytes per key instead of 42-44, with a few vector growths instead of
+// one node allocation per key. TroyBench ini times both on a troybin tree.
+template<typename Key, typename Value>
+class FlatMap {
+public:
+    using value_type = std::pair<Key, Value>;
+    using iterator = typename std::vector<value_type>::iterator;
+    using const_iterator = typename std::vector<value_type>::const_iterator;
+private:
+    inline constexpr static uint32_t none = 0xFFFFFFFFu;
+
+    struct Slot {
+        uint32_t key;
+        uint32_t index;
+    };
+
+    std::vector<value_type> entries;
+    std::vector<Slot> slots;
+    uint32_t shift = 32;
+
+    inline size_t home(uint32_t key) const noexcept {
+        // IniHash of similar names only differ in low bits, spread them out
+        return shift == 32 ? 0 : static_cast<size_t>((key * 2654435761u) >> shift);
+    }
+
+    inline static void prefetch(void const* p) noexcept {
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE__)
+        _mm_prefetch(static_cast<char const*>(p), _MM_HINT_T0);
+#elif defined(__GNUC__)
+        __builtin_prefetch(p);
+#endif
+    }
+
+    inline size_t mask() const noexcept {
+        return slots.size() - 1;
+    }
+
+    inline size_t find_slot(uint32_t key) const noexcept {
+        if(slots.empty()) {
+            return none;
+        }
+        for(size_t s = home(key);; s = (s + 1) & mask()) {
+            auto const& slot = slots[s];
+            if(slot.index == none) {
+                return none;
+            }
+            if(slot.key == key) {
+                return s;
+            }
+        }
+    }
+
+    void rehash(size_t capacity) {
+        uint32_t bits = 4;
+        while((size_t{1} << bits) < capacity) {
+            bits++;
+        }
+        slots.assign(size_t{1} << bits, Slot { 0, none });
+        shift = 32 - bits;
+        for(size_t i = 0; i < entries.size(); i++) {
+            auto const key = static_cast<uint32_t>(entries[i].first);
+            auto s = home(key);
+            while(slots[s].index != none) {
+                s = (s + 1) & mask();
+            }
+            slots[s] = { key, static_cast<uint32_t>(i) };
+        }
+    }
+
+    // keep load factor under 3/4
+    inline void grow_for(size_t count) {
+        if(count * 4 > slots.size() * 3) {
+            rehash(std::max(count * 2, slots.size() * 2));
+        }
+    }
+public:
+    inline iterator begin() noexcept { return entries.begin(); }
+    inline iterator end() noexcept { return entries.end(); }
+    inline const_iterator begin() const noexcept { return entries.begin(); }
+    inline const_iterator end() const noexcept { return entries.end(); }
+    inline const_iterator cbegin() const noexcept { return entries.cbegin(); }
+    inline const_iterator cend() const noexcept { return entries.cend(); }
+
+    inline size_t size() const noexcept { return entries.size(); }
+    inline bool empty() const noexcept { return entries.empty(); }
+
+    inline void clear() noexcept {
+        entries.clear();
+        slots.clear();
+        shift = 32;
+    }
+
+    inline void reserve(size_t count) {
+        entries.reserve(count);
+        grow_for(count);
+    }
+
+    inline const_iterator find(Key key) const noexcept {
+        if(auto const s = find_slot(static_cast<uint32_t>(key)); s != none) {
+            return entries.begin() + slots[s].index;
+        }
+        return entries.end();
+    }
+
+    inline iterator find(Key key) noexcept {
+        if(auto const s = find_slot(static_cast<uint32_t>(key)); s != none) {
+            return entries.begin() + slots[s].index;
+        }
+        return entries.end();
+    }
+
+    // Finds count keys at once, out[i] is end() when keys[i] is missing.
+    // Home slots of a group are prefetched before any of them is probed
+    // so the cache misses overlap instead of being paid one after another.
+    template<typename K>
+    inline void find_batch(K const* keys, size_t count,
+                           const_iterator* out) const noexcept {
+        constexpr size_t group = 8;
+        size_t homes[group];
+        for(size_t beg = 0; beg < count; beg += group) {
+            auto const size = std::min(group, count - beg);
+            if(slots.empty()) {
+                std::fill_n(out + beg, size, entries.end());
+                continue;
+            }
+            for(size_t i = 0; i < size; i++) {
+                homes[i] = home(static_cast<uint32_t>(keys[beg + i]));
+                prefetch(&slots[homes[i]]);
+            }
+            for(size_t i = 0; i < size; i++) {
+                auto const key = static_cast<uint32_t>(keys[beg + i]);
+                out[beg + i] = entries.end();
+                for(size_t s = homes[i]; slots[s].index != none; s = (s + 1) & mask()) {
+                    if(slots[s].key == key) {
+                        out[beg + i] = entries.begin() + slots[s].index;
+                        prefetch(&entries[slots[s].index]);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    template<typename...Args>
+    std::pair<iterator, bool> try_emplace(Key key, Args&&...args) {
+        grow_for(entries.size() + 1);
+        auto const k = static_cast<uint32_t>(key);
+        auto s = home(k);
+        for(; slots[s].index != none; s = (s + 1) & mask()) {
+            if(slots[s].key == k) {
+                return { entries.begin() + slots[s].index, false };
+            }
+        }
+        slots[s] = { k, static_cast<uint32_t>(entries.size()) };
+        entries.emplace_back(std::piecewise_construct,
+                             std::forward_as_tuple(key),
+                             std::forward_as_tuple(std::forward<Args>(args)...));
+        return { entries.end() - 1, true };
+    }
+
+    inline Value& operator[](Key key) {
+        return try_emplace(key).first->second;
+    }
+
+    size_t erase(Key key) {
+        auto s = find_slot(static_cast<uint32_t>(key));
+        if(s == none) {
+            return 0;
+        }
+        auto const index = slots[s].index;
+        // backward shift so probe chains stay unbroken
+        for(auto next = (s + 1) & mask(); slots[next].index != none; next = (next + 1) & mask()) {
+            auto const h = home(slots[next].key);
+            if(((next - h) & mask()) >= ((next - s) & mask())) {
+                slots[s] = slots[next];
+                s = next;
+            }
+        }
+        slots[s].index = none;
+        // move last entry into the hole
+        auto const last = static_cast<uint32_t>(entries.size() - 1);
+        if(index != last) {
+            // keys may not be assignable (IniHash), rebuild in place
+            entries[index].~value_type();
+            new (&entries[index]) value_type(std::move(entries.back()));
+            slots[find_slot(static_cast<uint32_t>(entries[index].first))].index = index;
+        }
+        entries.pop_back();
+        return 1;
+    }
+};
+
+#endif // FLATMAP_HPP
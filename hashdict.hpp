@@ -0,0 +1,301 @@
+#ifndef HASHDICT_HPP
+#define HASHDICT_HPP
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "flatmap.hpp"
+#include "bloom.hpp"
+
+// IniHash of a string split in two, hash when starting from 0 and 65599^length,
+// so hash(a + b) = hash(a) * mult(b) + hash(b) and names can be glued together
+// without hashing the common parts again
+struct HashPart {
+    uint32_t hash = 0;
+    uint32_t mult = 1;
+};
+
+inline constexpr HashPart operator+(HashPart const left, HashPart const right) noexcept {
+    return { left.hash * right.mult + right.hash, left.mult * right.mult };
+}
+
+// Hashes count strings, lanes strings at a time with one character of each
+// per step so the multiply-adds run side by side
+inline void hash_parts(std::string const* strs, size_t count, HashPart* out) noexcept {
+    constexpr size_t lanes = 8;
+    for(size_t beg = 0; beg < count; beg += lanes) {
+        auto const size = std::min(lanes, count - beg);
+        uint32_t hash[lanes] = {};
+        uint32_t mult[lanes];
+        uint32_t chars[lanes];
+        uint32_t live[lanes];
+        size_t longest = 0;
+        for(size_t l = 0; l < lanes; l++) {
+            mult[l] = 1;
+            if(l < size) {
+                longest = std::max(longest, strs[beg + l].size());
+            }
+        }
+        for(size_t c = 0; c < longest; c++) {
+            for(size_t l = 0; l < lanes; l++) {
+                auto const in = l < size && c < strs[beg + l].size();
+                auto const ch = in ? static_cast<uint32_t>(strs[beg + l][c]) : 0u;
+                chars[l] = ch >= 'A' && ch <= 'Z' ? ch + ('a' - 'A') : ch;
+                live[l] = in ? 0xFFFFFFFFu : 0u;
+            }
+            for(size_t l = 0; l < lanes; l++) {
+                auto const next_hash = hash[l] * 65599U + chars[l];
+                auto const next_mult = mult[l] * 65599U;
+                hash[l] = (next_hash & live[l]) | (hash[l] & ~live[l]);
+                mult[l] = (next_mult & live[l]) | (mult[l] & ~live[l]);
+            }
+        }
+        for(size_t l = 0; l < size; l++) {
+            out[beg + l] = { hash[l], mult[l] };
+        }
+    }
+}
+
+// Resolves IniHash values back to names by trying every name a set of
+// patterns builds out of a word list.
+// In a pattern %w stands for any word, %u for a number below numbers and
+// %% for a literal %, e.g. "GroupPart%uType" or "%w*p-%w".
+class HashDict {
+public:
+    struct Match {
+        uint32_t hash;
+        std::string name;
+
+        inline bool operator<(Match const& other) const noexcept {
+            return hash != other.hash ? hash < other.hash : name < other.name;
+        }
+
+        inline bool operator==(Match const& other) const noexcept {
+            return hash == other.hash && name == other.name;
+        }
+    };
+private:
+    enum class Kind { Literal, Word, Number };
+
+    struct Segment {
+        Kind kind;
+        std::string text;
+        HashPart part;
+    };
+
+    using Pattern = std::vector<Segment>;
+
+    std::vector<Pattern> patterns;
+    FlatMap<uint32_t, uint32_t> targets;
+    PresenceFilter filter;
+    // sorted, hashes that collide keep every name
+    std::vector<Match> matches;
+
+    struct Values {
+        std::vector<std::string> const* names;
+        std::vector<HashPart> parts;
+    };
+
+    inline Values const& values_of(Kind kind, Values const& words,
+                                   Values const& numbers) const noexcept {
+        return kind == Kind::Word ? words : numbers;
+    }
+
+    template<typename Emit>
+    inline void expand(Pattern const& pattern, size_t seg, HashPart const h,
+                       size_t* picks, Values const& words, Values const& numbers,
+                       Emit const& emit) const noexcept {
+        if(seg == pattern.size()) {
+            emit(h.hash, picks);
+            return;
+        }
+        auto const& segment = pattern[seg];
+        if(segment.kind == Kind::Literal) {
+            expand(pattern, seg + 1, h + segment.part, picks, words, numbers, emit);
+            return;
+        }
+        auto const& values = values_of(segment.kind, words, numbers);
+        for(size_t i = 0; i < values.parts.size(); i++) {
+            picks[seg] = i;
+            expand(pattern, seg + 1, h + values.parts[i], picks, words, numbers, emit);
+        }
+    }
+
+    inline std::string name_of(Pattern const& pattern, size_t const* picks,
+                               Values const& words, Values const& numbers) const {
+        std::string name;
+        for(size_t seg = 0; seg < pattern.size(); seg++) {
+            auto const& segment = pattern[seg];
+            if(segment.kind == Kind::Literal) {
+                name += segment.text;
+            } else {
+                name += (*values_of(segment.kind, words, numbers).names)[picks[seg]];
+            }
+        }
+        return name;
+    }
+
+    // Everything up to the first %w or %u is hashed once, work is split
+    // over the values of that slot
+    inline static size_t first_slot(Pattern const& pattern) noexcept {
+        for(size_t seg = 0; seg < pattern.size(); seg++) {
+            if(pattern[seg].kind != Kind::Literal) {
+                return seg;
+            }
+        }
+        return pattern.size();
+    }
+public:
+    // Hash to look for
+    inline void want(uint32_t h) {
+        targets.try_emplace(h, 0u);
+    }
+
+    inline size_t wanted() const noexcept { return targets.size(); }
+
+    // Returns -1 on a % not followed by w, u or %
+    inline int add_pattern(std::string_view str) {
+        Pattern pattern;
+        std::string literal;
+        auto const flush = [&] {
+            if(!literal.empty()) {
+                HashPart part;
+                hash_parts(&literal, 1, &part);
+                pattern.push_back({ Kind::Literal, std::move(literal), part });
+                literal.clear();
+            }
+        };
+        for(size_t i = 0; i < str.size(); i++) {
+            if(str[i] != '%') {
+                literal += str[i];
+                continue;
+            }
+            if(++i == str.size()) {
+                return -1;
+            }
+            if(str[i] == '%') {
+                literal += '%';
+            } else if(str[i] == 'w' || str[i] == 'u') {
+                flush();
+                pattern.push_back({ str[i] == 'w' ? Kind::Word : Kind::Number, {}, {} });
+            } else {
+                return -1;
+            }
+        }
+        flush();
+        patterns.push_back(std::move(pattern));
+        return 0;
+    }
+
+    // Tries every pattern with every word and number below numbers on
+    // threads threads, 0 uses one per core.
+    // Returns how many wanted hashes are resolved so far.
+    inline size_t resolve(std::vector<std::string> const& words, uint32_t numbers = 100,
+                          size_t threads = 0) {
+        std::vector<std::string> number_names;
+        for(uint32_t n = 0; n < numbers; n++) {
+            number_names.push_back(std::to_string(n));
+        }
+        Values word_values = { &words, std::vector<HashPart>(words.size()) };
+        Values number_values = { &number_names, std::vector<HashPart>(numbers) };
+        hash_parts(words.data(), words.size(), word_values.parts.data());
+        hash_parts(number_names.data(), number_names.size(), number_values.parts.data());
+
+        filter.reset(targets.size());
+        for(auto const& entry: targets) {
+            filter.insert(entry.first);
+        }
+
+        // one job per pattern and value of its first slot
+        struct Job {
+            size_t pattern;
+            size_t pick;
+        };
+        std::vector<Job> jobs;
+        for(size_t p = 0; p < patterns.size(); p++) {
+            auto const slot = first_slot(patterns[p]);
+            if(slot == patterns[p].size()) {
+                jobs.push_back({ p, 0 });
+                continue;
+            }
+            auto const& values = values_of(patterns[p][slot].kind, word_values, number_values);
+            for(size_t i = 0; i < values.parts.size(); i++) {
+                jobs.push_back({ p, i });
+            }
+        }
+
+        if(!threads) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        threads = std::max<size_t>(1, std::min(threads, jobs.size()));
+
+        std::atomic<size_t> next = 0;
+        std::vector<std::vector<Match>> found(threads);
+        auto const worker = [&](std::vector<Match>& out) {
+            std::vector<size_t> picks;
+            for(size_t j = next++; j < jobs.size(); j = next++) {
+                auto const& pattern = patterns[jobs[j].pattern];
+                picks.assign(pattern.size() + 1, 0);
+                HashPart h = {};
+                auto const slot = first_slot(pattern);
+                for(size_t seg = 0; seg < slot; seg++) {
+                    h = h + pattern[seg].part;
+                }
+                auto const emit = [&](uint32_t hash, size_t const* chosen) {
+                    if(filter.maybe_contains(hash) && targets.find(hash) != targets.end()) {
+                        out.push_back({ hash, name_of(pattern, chosen, word_values, number_values) });
+                    }
+                };
+                if(slot == pattern.size()) {
+                    emit(h.hash, picks.data());
+                    continue;
+                }
+                auto const& values = values_of(pattern[slot].kind, word_values, number_values);
+                picks[slot] = jobs[j].pick;
+                expand(pattern, slot + 1, h + values.parts[jobs[j].pick], picks.data(),
+                       word_values, number_values, emit);
+            }
+        };
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        for(size_t t = 0; t < threads; t++) {
+            workers.emplace_back(worker, std::ref(found[t]));
+        }
+        for(auto& w: workers) {
+            w.join();
+        }
+
+        for(auto& part: found) {
+            matches.insert(matches.end(),
+                           std::make_move_iterator(part.begin()),
+                           std::make_move_iterator(part.end()));
+        }
+        std::sort(matches.begin(), matches.end());
+        matches.erase(std::unique(matches.begin(), matches.end()), matches.end());
+        return resolved();
+    }
+
+    // Number of distinct hashes with at least one name
+    inline size_t resolved() const noexcept {
+        size_t result = 0;
+        for(size_t i = 0; i < matches.size(); i++) {
+            if(i == 0 || matches[i].hash != matches[i - 1].hash) {
+                result++;
+            }
+        }
+        return result;
+    }
+
+    inline std::vector<Match> const& all() const noexcept { return matches; }
+
+    // First name found for h by sort order, nullptr when unresolved
+    inline std::string const* find(uint32_t h) const noexcept {
+        auto const i = std::lower_bound(matches.begin(), matches.end(), h,
+                                        [](Match const& m, uint32_t h) { return m.hash < h; });
+        return i != matches.end() && i->hash == h ? &i->name : nullptr;
+    }
+};
+
+#endif // HASHDICT_HPP
@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "file.hpp"
+#include "inibin.h"
+#include "hashdict.hpp"
+#include "paths.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+// One entry per line, empty lines and lines starting with # are skipped
+int read_lines(char const* filename, std::vector<std::string>& out) noexcept {
+    auto const file = StdioFile::readb(filename, 0);
+    std::vector<char> data;
+    if(!file || !file->read(data, file->end)) {
+        return -1;
+    }
+    std::string line;
+    auto const flush = [&] {
+        while(!line.empty() && (line.back() == '\r' || line.back() == ' ')) {
+            line.pop_back();
+        }
+        if(!line.empty() && line[0] != '#') {
+            out.push_back(std::move(line));
+        }
+        line.clear();
+    };
+    for(auto const c: data) {
+        if(c == '\n') {
+            flush();
+        } else {
+            line += c;
+        }
+    }
+    flush();
+    return 0;
+}
+
+// Wants every hash of the file, single word string values such as
+// emitter names are added to the word list
+int scan_file(fs::path const& path, HashDict& dict, std::vector<std::string>& words) noexcept {
+    Ini ini{};
+    if(auto r = ini.from_file(path.string().c_str(), true); r) {
+        fprintf(stderr, "failed to read %s: %d\n", path.string().c_str(), r);
+        return r;
+    }
+    std::vector<uint32_t> hashes;
+    ini.hashes(hashes);
+    for(auto const h: hashes) {
+        dict.want(h);
+        if(std::string str; ini_get(ini.get(h), str) && !str.empty()
+                && str.find_first_of(" \t") == std::string::npos) {
+            words.push_back(std::move(str));
+        }
+    }
+    return 0;
+}
+}
+
+int main(int argc, char** argv) {
+    size_t threads = 0;
+    uint32_t numbers = 100;
+    while(argc > 2 && argv[1][0] == '-') {
+        if(std::string(argv[1]) == "-t") {
+            threads = strtoul(argv[2], nullptr, 10);
+        } else if(std::string(argv[1]) == "-n") {
+            numbers = static_cast<uint32_t>(strtoul(argv[2], nullptr, 10));
+        } else {
+            break;
+        }
+        argv += 2;
+        argc -= 2;
+    }
+    if(argc < 4) {
+        fprintf(stderr, "usage: %s [-t threads] [-n numbers] <words.txt> <patterns.txt> "
+                        "<troybin|dir>...\n", argv[0]);
+        fprintf(stderr, "patterns: %%w any word, %%u 0 to numbers - 1, %%%% a %%\n");
+        return 1;
+    }
+    HashDict dict{};
+    std::vector<std::string> words;
+    if(read_lines(argv[1], words)) {
+        fprintf(stderr, "failed to read words: %s\n", argv[1]);
+        return 1;
+    }
+    std::vector<std::string> patterns;
+    if(read_lines(argv[2], patterns)) {
+        fprintf(stderr, "failed to read patterns: %s\n", argv[2]);
+        return 1;
+    }
+    for(auto const& pattern: patterns) {
+        if(dict.add_pattern(pattern)) {
+            fprintf(stderr, "bad pattern: %s\n", pattern.c_str());
+            return 1;
+        }
+    }
+    for(int i = 3; i < argc; i++) {
+        fs::path const in = argv[i];
+        std::error_code ec;
+        if(!fs::is_directory(in, ec)) {
+            scan_file(in, dict, words);
+            continue;
+        }
+        ec = for_each_file(in, [&](fs::path const& path) {
+            if(is_troybin(path)) {
+                scan_file(path, dict, words);
+            }
+        });
+        if(ec) {
+            fprintf(stderr, "failed to list: %s\n", argv[i]);
+            return 1;
+        }
+    }
+    std::sort(words.begin(), words.end());
+    words.erase(std::unique(words.begin(), words.end()), words.end());
+
+    auto const resolved = dict.resolve(words, numbers, threads);
+    for(auto const& match: dict.all()) {
+        printf("%08X %s\n", match.hash, match.name.c_str());
+    }
+    fprintf(stderr, "resolved %zu of %zu hashes with %zu words\n",
+            resolved, dict.wanted(), words.size());
+    return 0;
+}
@@ -1,47 +1,131 @@
 #include "inibin.h"
 #include <cstdio>
 #include <type_traits>
+#include <algorithm>
+#include <cstring>
+#include <charconv>
+#include <mutex>
+#include <cmath>
 #include "file.hpp"
-
-using IniMap = Ini::IniMap;
+#include "pack.hpp"
 
 namespace {
-template<typename T, bool mult = false>
-int read_numbers(File const& file, IniMap& ini) noexcept {
+inline char const* skip_space(char const* str, char const* end) noexcept {
+    while(str != end && (*str == ' ' || (*str >= '\t' && *str <= '\r'))) {
+        str++;
+    }
+    // from_chars does not take a leading plus
+    if(str != end && *str == '+' && end - str > 1 && str[1] != '-') {
+        str++;
+    }
+    return str;
+}
+
+// Same as sscanf with "%f %f ...", returns how many floats were read
+inline size_t parse_floats(std::string_view str, float* out, size_t count) noexcept {
+    auto cur = str.data();
+    auto const end = str.data() + str.size();
+    for(size_t i = 0; i < count; i++) {
+        cur = skip_space(cur, end);
+        auto const [next, ec] = std::from_chars(cur, end, out[i]);
+        if(ec != std::errc{}) {
+            return i;
+        }
+        cur = next;
+    }
+    return count;
+}
+
+// Same as atof, 0 when nothing could be read
+inline float parse_float(std::string_view str) noexcept {
+    float result = 0.0f;
+    return parse_floats(str, &result, 1) ? result : 0.0f;
+}
+
+// Same as atoi, 0 when nothing could be read
+inline int32_t parse_int(std::string_view str) noexcept {
+    auto const end = str.data() + str.size();
+    int32_t result = 0;
+    if(std::from_chars(skip_space(str.data(), end), end, result).ec != std::errc{}) {
+        return 0;
+    }
+    return result;
+}
+
+// Digits with optional sign, point and exponent, no inf, nan or hex
+inline bool is_plain_decimal(char const* beg, char const* end) noexcept {
+    return beg != end && std::all_of(beg, end, [](char c) {
+        return (c >= '0' && c <= '9') || c == '.' || c == '-' || c == '+' || c == 'e' || c == 'E';
+    });
+}
+
+// Reads up to count finite plain decimal numbers when str holds nothing else, 0 otherwise
+inline size_t parse_only_floats(std::string_view str, float* out, size_t count) noexcept {
+    auto cur = str.data();
+    auto const end = str.data() + str.size();
+    size_t i = 0;
+    for(; i < count; i++) {
+        cur = skip_space(cur, end);
+        auto const [next, ec] = std::from_chars(cur, end, out[i]);
+        if(ec != std::errc{}) {
+            break;
+        }
+        if(!is_plain_decimal(cur, next) || !std::isfinite(out[i])) {
+            return 0;
+        }
+        cur = next;
+    }
+    return skip_space(cur, end) == end ? i : 0;
+}
+
+inline int copy_floats(float const* src, size_t size, float* out, size_t count) noexcept {
+    auto const n = std::min(size, count);
+    std::copy_n(src, n, out);
+    return static_cast<int>(n);
+}
+
+template<typename T, bool mult = false, typename File>
+int read_numbers(File const& file, Ini& ini) noexcept {
     uint16_t count = {};
-    std::vector<uint32_t> hashes{};
-    std::vector<T> values{};
+    Span<uint32_t> hashes{};
+    Span<T> values{};
+    std::vector<uint32_t> hashes_storage{};
+    std::vector<T> values_storage{};
     if(!file.read(count)) {
         return -1;
     }
-    if(!file.read(hashes, count)) {
+    if(!file.read_view(hashes, hashes_storage, count)) {
         return -2;
     }
-    if(!file.read(values, count)) {
+    if(!file.read_view(values, values_storage, count)) {
         return -3;
     }
     for(uint32_t i = 0; i < count; i++) {
         if constexpr(mult) {
             ini.try_emplace(hashes[i], values[i] / 10.0f);
-        } else {
+        } else if constexpr(std::is_same_v<T, float>) {
             ini.try_emplace(hashes[i], values[i]);
+        } else {
+            ini.try_emplace(hashes[i], static_cast<int32_t>(values[i]));
         }
     }
     return 0;
 }
 
-template<typename T, size_t size, bool mult = false>
-int read_array(File const& file, IniMap& ini) noexcept {
+template<typename T, size_t size, bool mult = false, typename File>
+int read_array(File const& file, Ini& ini) noexcept {
     uint16_t count{};
-    std::vector<uint32_t> hashes{};
-    std::vector<std::array<T, size>> values{};
+    Span<uint32_t> hashes{};
+    Span<std::array<T, size>> values{};
+    std::vector<uint32_t> hashes_storage{};
+    std::vector<std::array<T, size>> values_storage{};
     if(!file.read(count)) {
         return -1;
     }
-    if(!file.read(hashes, count)) {
+    if(!file.read_view(hashes, hashes_storage, count)) {
         return -2;
     }
-    if(!file.read(values, count)) {
+    if(!file.read_view(values, values_storage, count)) {
         return -3;
     }
     for(uint32_t i = 0; i < count; i++) {
@@ -58,14 +142,16 @@ int read_array(File const& file, IniMap& ini) noexcept {
     return 0;
 }
 
-int read_bools(File const& file, IniMap& ini) noexcept {
+template<typename File>
+int read_bools(File const& file, Ini& ini) noexcept {
     uint16_t count{};
-    std::vector<uint32_t> hashes{};
+    Span<uint32_t> hashes{};
+    std::vector<uint32_t> hashes_storage{};
     std::vector<uint8_t> data{};
     if(!file.read(count)) {
         return -1;
     }
-    if(!file.read(hashes, count)) {
+    if(!file.read_view(hashes, hashes_storage, count)) {
         return -2;
     }
     size_t size = (count / 8) + (count % 8 ? 1 : 0);
@@ -78,19 +164,22 @@ int read_bools(File const& file, IniMap& ini) noexcept {
     return 0;
 }
 
-int read_strings(File const& file, IniMap& ini,
+template<typename File>
+int read_strings(File const& file, Ini& ini,
                         size_t data_size) noexcept {
     uint16_t count{};
-    std::vector<uint32_t> hashes{};
-    std::vector<uint16_t> offsets{};
+    Span<uint32_t> hashes{};
+    Span<uint16_t> offsets{};
+    std::vector<uint32_t> hashes_storage{};
+    std::vector<uint16_t> offsets_storage{};
     std::vector<char> data;
     if(!file.read(count)) {
         return -1;
     }
-    if(!file.read(hashes, count)) {
+    if(!file.read_view(hashes, hashes_storage, count)) {
         return -2;
     }
-    if(!file.read(offsets, count)) {
+    if(!file.read_view(offsets, offsets_storage, count)) {
         return -3;
     }
     if(!file.read(data, data_size)) {
@@ -103,33 +192,22 @@ int read_strings(File const& file, IniMap& ini,
         if(off >= data.size()) {
             return -5;
         }
-        ini.try_emplace(hashes[i], std::string(&data[off]));
+        ini.try_emplace(hashes[i], std::string_view(&data[off]));
     }
     return 0;
 }
 
-inline int read_v2(const char *filename, IniMap& ini) noexcept {
-    FILE *f;
-    if(fopen_s(&f, filename, "rb")) {
-        return -1;
-    }
-    File file = {f};
-
+template<typename File>
+inline int read_v2(File const& file, Ini& ini) noexcept {
     uint8_t version;
-    if(!file.read(version)) {
+    uint16_t strings_data_length;
+    uint16_t flags;
+    if(!file.read_struct_batch(version, strings_data_length, flags)) {
         return -2;
     }
     if(version != 2) {
         return -3;
     }
-    uint16_t strings_data_length;
-    if(!file.read(strings_data_length)) {
-        return -4;
-    }
-    uint16_t flags;
-    if(!file.read(flags)) {
-        return -5;
-    }
     if(flags & (1 << 0)) {
         if(auto r = read_numbers<int32_t>(file, ini); r) {
             return r - 10;
@@ -199,27 +277,486 @@ inline int read_v2(const char *filename, IniMap& ini) noexcept {
 }
 }
 
-int Ini::from_file(const char *filename) noexcept
+int Ini::from_file(const char *filename, bool lazy) noexcept
+{
+    auto const file = StdioFile::readb(filename, lazy ? 0 : StdioFile::default_window);
+    if(!file) {
+        return -1;
+    }
+    if(!lazy) {
+        return read_v2(*file, *this);
+    }
+    auto data = std::make_shared<std::vector<uint8_t>>();
+    if(!file->read(*data, file->end)) {
+        return -2;
+    }
+    if(auto r = from_view(data->data(), data->size()); r) {
+        return r;
+    }
+    view_data = std::move(data);
+    return 0;
+}
+
+namespace {
+struct WriteSection {
+    std::vector<uint32_t> hashes;
+    std::vector<uint8_t> data;
+
+    template<typename T>
+    inline void push(uint32_t h, T const& value) noexcept {
+        hashes.push_back(h);
+        auto const src = reinterpret_cast<uint8_t const*>(&value);
+        data.insert(data.end(), src, src + sizeof(T));
+    }
+};
+
+inline bool same_bits(float l, float r) noexcept {
+    return memcmp(&l, &r, sizeof(float)) == 0;
+}
+
+// value as k / 10 with k in 0..255, the way the u8 sections are read back
+inline bool pack_tenths(float value, uint8_t& out) noexcept {
+    if(!(value >= 0.0f && value <= 25.5f)) {
+        return false;
+    }
+    auto const k = static_cast<uint8_t>(value * 10.0f + 0.5f);
+    out = k;
+    return same_bits(k / 10.0f, value);
+}
+
+template<size_t size>
+inline bool pack_tenths(std::array<float, size> const& value,
+                        std::array<uint8_t, size>& out) noexcept {
+    for(size_t c = 0; c < size; c++) {
+        if(!pack_tenths(value[c], out[c])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// sections in read_v2 order
+enum : size_t {
+    Int32, Float, Tenths, Int16, Uint8, Bools,
+    Tenths3, Vec3, Tenths2, Vec2, Tenths4, Vec4, Strings
+};
+
+template<size_t size>
+inline void push_vector(std::array<WriteSection, 13>& sections, uint32_t h,
+                        std::array<float, size> const& value) noexcept {
+    constexpr size_t packed = size == 2 ? Tenths2 : size == 3 ? Tenths3 : Tenths4;
+    constexpr size_t full = size == 2 ? Vec2 : size == 3 ? Vec3 : Vec4;
+    if(std::array<uint8_t, size> tenths; pack_tenths(value, tenths)) {
+        sections[packed].push(h, tenths);
+    } else {
+        sections[full].push(h, value);
+    }
+}
+
+inline void push_value(std::array<WriteSection, 13>& sections,
+                       std::vector<char>& strings, uint32_t h,
+                       IniValue const& value, bool bake) noexcept {
+    std::visit([&](auto&& value) {
+        using T = std::decay_t<decltype(value)>;
+        if constexpr(std::is_same_v<T, int32_t>) {
+            if(value == 0 || value == 1) {
+                sections[Bools].push(h, static_cast<uint8_t>(value));
+            } else if(value >= 0 && value <= 0xFF) {
+                sections[Uint8].push(h, static_cast<uint8_t>(value));
+            } else if(value >= INT16_MIN && value <= INT16_MAX) {
+                sections[Int16].push(h, static_cast<int16_t>(value));
+            } else {
+                sections[Int32].push(h, value);
+            }
+        } else if constexpr(std::is_same_v<T, float>) {
+            if(uint8_t tenths; pack_tenths(value, tenths)) {
+                sections[Tenths].push(h, tenths);
+            } else {
+                sections[Float].push(h, value);
+            }
+        } else if constexpr(std::is_same_v<T, std::string>) {
+            float numbers[4];
+            auto const count = bake ? parse_only_floats(value, numbers, 4) : 0;
+            if(count == 1) {
+                int32_t i = {};
+                auto const end = value.data() + value.size();
+                auto const beg = skip_space(value.data(), end);
+                if(auto const r = std::from_chars(beg, end, i); r.ec == std::errc{}
+                        && skip_space(r.ptr, end) == end) {
+                    push_value(sections, strings, h, i, false);
+                } else {
+                    push_value(sections, strings, h, numbers[0], false);
+                }
+            } else if(count == 2) {
+                push_vector(sections, h, std::array<float, 2> { numbers[0], numbers[1] });
+            } else if(count == 3) {
+                push_vector(sections, h, std::array<float, 3> { numbers[0], numbers[1], numbers[2] });
+            } else if(count == 4) {
+                push_vector(sections, h, std::array<float, 4> {
+                                numbers[0], numbers[1], numbers[2], numbers[3]
+                            });
+            } else {
+                sections[Strings].push(h, static_cast<uint16_t>(strings.size()));
+                strings.insert(strings.end(), value.begin(), value.end());
+                strings.push_back('\0');
+            }
+        } else if constexpr(!std::is_same_v<T, std::nullptr_t>) {
+            push_vector(sections, h, value);
+        }
+    }, value);
+}
+}
+
+int Ini::to_memory(std::vector<uint8_t>& out, bool bake) const noexcept {
+    std::vector<uint32_t> keys;
+    keys.reserve(size());
+    hashes(keys);
+    // sorted sections are binary searched in place by IniView
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    std::array<WriteSection, 13> sections;
+    std::vector<char> string_data;
+    for(auto const h: keys) {
+        push_value(sections, string_data, h, get(h), bake);
+    }
+    if(string_data.size() > 0xFFFF) {
+        return -2;
+    }
+
+    uint8_t const version = 2;
+    auto const strings_data_length = static_cast<uint16_t>(string_data.size());
+    uint16_t flags = 0;
+    for(size_t s = 0; s < sections.size(); s++) {
+        if(sections[s].hashes.size() > 0xFFFF) {
+            return -1;
+        }
+        if(!sections[s].hashes.empty()) {
+            flags |= static_cast<uint16_t>(1u << s);
+        }
+    }
+
+    auto const write = [&out](void const* data, size_t size) {
+        auto const src = static_cast<uint8_t const*>(data);
+        out.insert(out.end(), src, src + size);
+    };
+    out.clear();
+    write(&version, sizeof(version));
+    write(&strings_data_length, sizeof(strings_data_length));
+    write(&flags, sizeof(flags));
+    for(size_t s = 0; s < sections.size(); s++) {
+        auto& section = sections[s];
+        if(section.hashes.empty()) {
+            continue;
+        }
+        auto const count = static_cast<uint16_t>(section.hashes.size());
+        write(&count, sizeof(count));
+        write(section.hashes.data(), section.hashes.size() * sizeof(uint32_t));
+        if(s == Bools) {
+            std::vector<uint8_t> bits((count + 7u) / 8u);
+            for(size_t i = 0; i < count; i++) {
+                bits[i / 8] |= static_cast<uint8_t>(section.data[i] << (i % 8));
+            }
+            write(bits.data(), bits.size());
+        } else {
+            write(section.data.data(), section.data.size());
+        }
+    }
+    write(string_data.data(), string_data.size());
+    return 0;
+}
+
+int Ini::to_file(char const* filename, bool bake) const noexcept {
+    std::vector<uint8_t> data;
+    if(auto r = to_memory(data, bake); r) {
+        return r;
+    }
+    FILE* f = nullptr;
+    if(fopen_s(&f, filename, "wb") || !f) {
+        return -3;
+    }
+    auto const written = fwrite(data.data(), 1, data.size(), f);
+    if(fclose(f) || written != data.size()) {
+        return -4;
+    }
+    return 0;
+}
+
+int Ini::from_memory(uint8_t const* data, size_t size) noexcept
+{
+    return read_v2(MemoryFile::from_memory(data, size), *this);
+}
+
+int Ini::from_pack(Pack const& pack, char const* path) noexcept
+{
+    auto const h = Pack::hash_path(path);
+    if(auto const file = pack.open(h); file) {
+        return read_v2(*file, *this);
+    }
+    if(auto const file = pack.stream(h); file) {
+        return read_v2(*file, *this);
+    }
+    return -1;
+}
+
+int Ini::from_view(uint8_t const* data, size_t size) noexcept
+{
+    parsed.clear();
+    parsed_floats.clear();
+    view_data.reset();
+    if(auto r = view.emplace().load(data, size); r) {
+        view.reset();
+        return r;
+    }
+    rebuild_filter();
+    return 0;
+}
+
+int Ini::from_base(std::shared_ptr<Ini const> base) noexcept
 {
-    return read_v2(filename, values);
+    if(!base) {
+        return -1;
+    }
+    clear();
+    this->base = std::move(base);
+    rebuild_filter();
+    return 0;
+}
+
+Ini Ini::flatten() const noexcept {
+    Ini result = base ? *base : *this;
+    result.reset_lookup_stats();
+    if(!base) {
+        return result;
+    }
+    if(view) {
+        std::vector<uint32_t> keys;
+        view->hashes(keys);
+        for(auto const h: keys) {
+            if(values.find(h) == values.end()) {
+                result.set(h, view->get(h));
+            }
+        }
+    }
+    for(auto const& entry: values) {
+        result.set(entry.first, load(entry.second));
+    }
+    return result;
+}
+
+void Ini::hashes(std::vector<uint32_t>& out) const noexcept {
+    for(auto const& entry: values) {
+        out.push_back(entry.first);
+    }
+    if(view) {
+        view->hashes(out);
+    }
+    if(base) {
+        base->hashes(out);
+    }
+}
+
+void Ini::rebuild_filter() noexcept {
+    // room to grow before the next rebuild
+    filter.reset(layer_size() * 2);
+    for(auto const& entry: values) {
+        filter.insert(entry.first);
+    }
+    if(view) {
+        std::vector<uint32_t> keys;
+        view->hashes(keys);
+        for(auto const h: keys) {
+            filter.insert(h);
+        }
+    }
+}
+
+Ini::IniValue Ini::find(IniHash h, bool& probed) const noexcept {
+    if(filter.maybe_contains(h)) {
+        probed = true;
+        if(auto const r = values.find(h); r != values.end()) {
+            return load(r->second);
+        }
+        if(view) {
+            if(auto result = view->get(h); result.index()) {
+                return result;
+            }
+        }
+    }
+    return find_base(h, probed);
+}
+
+bool Ini::contains(IniHash h) const noexcept {
+    if(filter.maybe_contains(h)) {
+        if(auto const r = values.find(h); r != values.end()) {
+            // erased values keep a null ref that hides base
+            return (r->second & 7) != 0;
+        }
+        if(view && view->contains(h)) {
+            return true;
+        }
+    }
+    return base && base->contains(h);
 }
 
 Ini::IniValue Ini::get(IniHash h) const noexcept {
-    if(auto r = values.find(h); r != values.end()) {
-        return r->second;
+    bool probed = false;
+    auto result = find(h, probed);
+    count_lookup(result.index(), probed);
+    return result;
+}
+
+int Ini::get_floats(IniHash h, float* out, size_t count) const noexcept {
+    {
+        std::shared_lock lock(parsed_lock.mutex);
+        if(auto const p = parsed.find(h); p != parsed.end()) {
+            count_lookup(true, true);
+            return copy_floats(parsed_floats.data() + (p->second >> 3), p->second & 7, out, count);
+        }
+    }
+    IniValue value = nullptr;
+    std::string_view str = {};
+    bool is_string = false;
+    bool probed = false;
+    // set here, erased included, so base is not asked
+    bool in_values = false;
+    if(filter.maybe_contains(h)) {
+        probed = true;
+        if(auto const r = values.find(h); r != values.end()) {
+            in_values = true;
+            if((r->second & 7) == 6) {
+                str = &strings[r->second >> 3];
+                is_string = true;
+            } else {
+                value = load(r->second);
+            }
+        } else if(view) {
+            value = view->get(h);
+        }
+    }
+    if(!in_values && !value.index()) {
+        value = find_base(h, probed);
+    }
+    if(!is_string) {
+        if(auto const v = std::get_if<std::string>(&value); v) {
+            str = *v;
+            is_string = true;
+        }
+    }
+    count_lookup(is_string || value.index(), probed);
+    if(!is_string) {
+        return std::visit([out, count](auto&& value) -> int {
+            using T = std::decay_t<decltype(value)>;
+            if constexpr(std::is_same_v<T, std::nullptr_t>) {
+                return -1;
+            } else if constexpr(std::is_same_v<T, int32_t>) {
+                auto const f = static_cast<float>(value);
+                return copy_floats(&f, 1, out, count);
+            } else if constexpr(std::is_same_v<T, float>) {
+                return copy_floats(&value, 1, out, count);
+            } else if constexpr(std::is_same_v<T, std::string>) {
+                return -1;
+            } else {
+                return copy_floats(value.data(), value.size(), out, count);
+            }
+        }, value);
+    }
+    // PColor keyframes have the most numbers with 5, 7 is what fits the ref
+    float result[7];
+    auto const size = parse_floats(str, result, 7);
+    {
+        // another reader may have parsed the same string meanwhile
+        std::unique_lock lock(parsed_lock.mutex);
+        if(parsed.try_emplace(h, static_cast<uint32_t>(parsed_floats.size() << 3 | size)).second) {
+            parsed_floats.insert(parsed_floats.end(), result, result + size);
+        }
+    }
+    return copy_floats(result, size, out, count);
+}
+
+void Ini::get_batch(IniHash const* keys, size_t count, IniValue* out) const noexcept {
+    constexpr size_t group = 32;
+    IniMap::const_iterator found[group];
+    // only keys that pass the presence filter are probed
+    uint32_t candidates[group];
+    size_t slots[group];
+    for(size_t beg = 0; beg < count; beg += group) {
+        auto const size = std::min(group, count - beg);
+        size_t probe = 0;
+        for(size_t i = 0; i < size; i++) {
+            if(filter.maybe_contains(keys[beg + i])) {
+                candidates[probe] = keys[beg + i];
+                slots[probe] = beg + i;
+                probe++;
+            } else {
+                bool probed = false;
+                auto& result = out[beg + i];
+                result = find_base(keys[beg + i], probed);
+                count_lookup(result.index(), probed);
+            }
+        }
+        values.find_batch(candidates, probe, found);
+        for(size_t i = 0; i < probe; i++) {
+            auto& result = out[slots[i]];
+            if(found[i] != values.end()) {
+                result = load(found[i]->second);
+                count_lookup(result.index(), true);
+                continue;
+            }
+            result = view ? view->get(candidates[i]) : nullptr;
+            if(!result.index()) {
+                bool probed = true;
+                result = find_base(candidates[i], probed);
+            }
+            count_lookup(result.index(), true);
+        }
+    }
+}
+
+Ini::IniValue Ini::load(uint32_t ref) const noexcept {
+    auto const index = ref >> 3;
+    switch(ref & 7) {
+    case 1:
+        return ints[index];
+    case 2:
+        return floats[index];
+    case 3:
+        return vec2s[index];
+    case 4:
+        return vec3s[index];
+    case 5:
+        return vec4s[index];
+    case 6:
+        return std::string(&strings[index]);
     }
     return nullptr;
 }
 
 void Ini::set(IniHash h, Ini::IniValue v) noexcept {
+    parsed.erase(h);
     if(std::holds_alternative<std::nullptr_t>(v)) {
-        values.erase(h);
+        bool probed = false;
+        if((view && view->get(h).index()) || find_base(h, probed).index()) {
+            values[h] = 0;
+            // lookups must stop here instead of falling through to base
+            filter_insert(h);
+        } else {
+            values.erase(h);
+        }
     } else {
-        values[h] = v;
+        values[h] = std::visit([this](auto&& value) -> uint32_t {
+            using T = std::decay_t<decltype(value)>;
+            if constexpr(std::is_same_v<T, std::nullptr_t>) {
+                return 0;
+            } else {
+                return store(value);
+            }
+        }, v);
+        filter_insert(h);
     }
 }
 
-bool ini_get(const Ini &ini, IniHash h, int32_t &val) noexcept {
+bool ini_get(IniValue const& v, int32_t &val) noexcept {
     return std::visit([&val](auto&& value) -> bool {
         using T = std::decay_t<decltype(value)>;
         if constexpr(std::is_same_v<T, float>) {
@@ -229,15 +766,15 @@ bool ini_get(const Ini &ini, IniHash h, int32_t &val) noexcept {
             val = value;
             return true;
         } else if constexpr(std::is_same_v<T, std::string>) {
-            val= atoi(value.c_str());
+            val = parse_int(value);
             return true;
         } else {
             return false;
         }
-    }, ini.get(h));
+    }, v);
 }
 
-bool ini_get(const Ini &ini, IniHash h, bool &val) noexcept {
+bool ini_get(IniValue const& v, bool &val) noexcept {
     return std::visit([&val](auto&& value) -> bool {
         using T = std::decay_t<decltype(value)>;
         if constexpr(std::is_same_v<T, float>) {
@@ -252,10 +789,10 @@ bool ini_get(const Ini &ini, IniHash h, bool &val) noexcept {
         } else {
             return false;
         }
-    }, ini.get(h));
+    }, v);
 }
 
-bool ini_get(const Ini &ini, IniHash h, float &val) noexcept {
+bool ini_get(IniValue const& v, float &val) noexcept {
     return std::visit([&val](auto&& value) -> bool {
         using T = std::decay_t<decltype(value)>;
         if constexpr(std::is_same_v<T, float>) {
@@ -265,15 +802,15 @@ bool ini_get(const Ini &ini, IniHash h, float &val) noexcept {
             val =  static_cast<float>(value);
             return true;
         } else if constexpr(std::is_same_v<T, std::string>) {
-            val = static_cast<float>(atof(value.c_str()));
+            val = parse_float(value);
             return true;
         } else {
             return false;
         }
-    }, ini.get(h));
+    }, v);
 }
 
-bool ini_get(const Ini &ini, IniHash h, std::string &val) noexcept {
+bool ini_get(IniValue const& v, std::string &val) noexcept {
     return std::visit([&val](auto&& value) -> bool {
         using T = std::decay_t<decltype(value)>;
         if constexpr(std::is_same_v<T, std::array<float, 2>>) {
@@ -324,10 +861,10 @@ bool ini_get(const Ini &ini, IniHash h, std::string &val) noexcept {
         } else {
             return false;
         }
-    }, ini.get(h));
+    }, v);
 }
 
-bool ini_get(const Ini &ini, IniHash h, std::array<float, 2> &val) noexcept {
+bool ini_get(IniValue const& v, std::array<float, 2> &val) noexcept {
     return std::visit([&val](auto&& value) -> bool {
         using T = std::decay_t<decltype(value)>;
         if constexpr(std::is_same_v<T, std::array<float, 2>>) {
@@ -335,9 +872,7 @@ bool ini_get(const Ini &ini, IniHash h, std::array<float, 2> &val) noexcept {
             return true;
         } else if constexpr(std::is_same_v<T, std::string>) {
             std::array<float, 2> result;
-            if(sscanf_s(value.c_str(), "%f %f",
-                        &result[0],
-                        &result[1]) == 2) {
+            if(parse_floats(value, result.data(), 2) == 2) {
                 val = result;
                 return true;
             }
@@ -345,10 +880,10 @@ bool ini_get(const Ini &ini, IniHash h, std::array<float, 2> &val) noexcept {
         } else {
             return false;
         }
-    }, ini.get(h));
+    }, v);
 }
 
-bool ini_get(const Ini &ini, IniHash h, std::array<float, 3> &val) noexcept {
+bool ini_get(IniValue const& v, std::array<float, 3> &val) noexcept {
     return std::visit([&val](auto&& value) -> bool {
         using T = std::decay_t<decltype(value)>;
         if constexpr(std::is_same_v<T, std::array<float, 3>>) {
@@ -356,10 +891,7 @@ bool ini_get(const Ini &ini, IniHash h, std::array<float, 3> &val) noexcept {
             return true;
         } else if constexpr(std::is_same_v<T, std::string>) {
             std::array<float, 3> result;
-            if(sscanf_s(value.c_str(), "%f %f %f",
-                        &result[0],
-                        &result[1],
-                        &result[2]) == 3) {
+            if(parse_floats(value, result.data(), 3) == 3) {
                 val = result;
                 return true;
             }
@@ -367,10 +899,10 @@ bool ini_get(const Ini &ini, IniHash h, std::array<float, 3> &val) noexcept {
         } else {
             return false;
         }
-    }, ini.get(h));
+    }, v);
 }
 
-bool ini_get(const Ini &ini, IniHash h, std::array<float, 4> &val) noexcept {
+bool ini_get(IniValue const& v, std::array<float, 4> &val) noexcept {
     return std::visit([&val](auto&& value) -> bool {
         using T = std::decay_t<decltype(value)>;
         if constexpr(std::is_same_v<T, std::array<float, 4>>) {
@@ -378,11 +910,7 @@ bool ini_get(const Ini &ini, IniHash h, std::array<float, 4> &val) noexcept {
             return true;
         } else if constexpr(std::is_same_v<T, std::string>) {
             std::array<float, 4> result;
-            if(sscanf_s(value.c_str(), "%f %f %f %f",
-                        &result[0],
-                        &result[1],
-                        &result[2],
-                        &result[3]) == 4) {
+            if(parse_floats(value, result.data(), 4) == 4) {
                 val = result;
                 return true;
             }
@@ -390,5 +918,192 @@ bool ini_get(const Ini &ini, IniHash h, std::array<float, 4> &val) noexcept {
         } else {
             return false;
         }
-    }, ini.get(h));
+    }, v);
+}
+
+namespace {
+// bytes per value in each section, bools are packed bits
+constexpr std::array<size_t, IniView::section_count> section_value_size = {
+    4, 4, 1, 2, 1, 0, 3, 12, 2, 8, 4, 16, 2
+};
+
+template<typename T>
+inline T load_unaligned(uint8_t const* data, size_t index) noexcept {
+    T result;
+    memcpy(&result, data + index * sizeof(T), sizeof(T));
+    return result;
+}
+
+template<size_t size>
+inline std::array<float, size> load_scaled(uint8_t const* data, size_t index) noexcept {
+    std::array<float, size> result;
+    for(size_t c = 0; c < size; c++) {
+        result[c] = data[index * size + c] / 10.0f;
+    }
+    return result;
+}
+}
+
+int IniView::load(uint8_t const* data, size_t size) noexcept {
+    auto const file = MemoryFile::from_memory(data, size);
+    uint8_t version;
+    uint16_t strings_data_length;
+    uint16_t flags;
+    if(!file.read_struct_batch(version, strings_data_length, flags)) {
+        return -2;
+    }
+    if(version != 2) {
+        return -3;
+    }
+    sections = {};
+    for(size_t s = 0; s < section_count; s++) {
+        if(!(flags & (1u << s))) {
+            continue;
+        }
+        auto const error = -10 * static_cast<int>(s + 1);
+        auto& section = sections[s];
+        uint16_t count = {};
+        if(!file.read(count)) {
+            return error - 1;
+        }
+        section.count = count;
+        if(section.hashes = file.fetch(count * sizeof(uint32_t)); !section.hashes) {
+            return error - 2;
+        }
+        auto const values_size = s == 5 ? (count + 7u) / 8u : count * section_value_size[s];
+        if(section.values = file.fetch(values_size); !section.values) {
+            return error - 3;
+        }
+        auto const hash_at = [&section](size_t i) {
+            return load_unaligned<uint32_t>(section.hashes, i);
+        };
+        for(size_t i = 1; i < count && section.sorted; i++) {
+            section.sorted = hash_at(i - 1) <= hash_at(i);
+        }
+        if(!section.sorted) {
+            // built here so lookups never write, the view may be shared between layers
+            section.order.resize(count);
+            for(size_t i = 0; i < count; i++) {
+                section.order[i] = static_cast<uint16_t>(i);
+            }
+            // stable so duplicate hashes resolve to the first one like read_v2
+            std::stable_sort(section.order.begin(), section.order.end(),
+                             [&hash_at](uint16_t l, uint16_t r) {
+                return hash_at(l) < hash_at(r);
+            });
+        }
+    }
+    if(flags & (1u << 12)) {
+        strings = reinterpret_cast<char const*>(file.fetch(strings_data_length));
+        if(!strings) {
+            return -134;
+        }
+        strings_size = strings_data_length;
+    }
+    return 0;
+}
+
+int32_t IniView::find(Section const& section, uint32_t h) const noexcept {
+    auto const hash_at = [&section](size_t i) {
+        return load_unaligned<uint32_t>(section.hashes, i);
+    };
+    auto const index_at = [&section](size_t i) -> size_t {
+        return section.sorted ? i : section.order[i];
+    };
+    size_t lo = 0;
+    size_t hi = section.count;
+    while(lo < hi) {
+        auto const mid = lo + (hi - lo) / 2;
+        if(hash_at(index_at(mid)) < h) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if(lo < section.count && hash_at(index_at(lo)) == h) {
+        return static_cast<int32_t>(index_at(lo));
+    }
+    return -1;
+}
+
+IniValue IniView::get(IniHash h) const noexcept {
+    for(size_t s = 0; s < section_count; s++) {
+        auto const& section = sections[s];
+        if(!section.count) {
+            continue;
+        }
+        auto const found = find(section, h);
+        if(found < 0) {
+            continue;
+        }
+        auto const i = static_cast<size_t>(found);
+        auto const values = section.values;
+        switch(s) {
+        case 0:
+            return load_unaligned<int32_t>(values, i);
+        case 1:
+            return load_unaligned<float>(values, i);
+        case 2:
+            return values[i] / 10.0f;
+        case 3:
+            return static_cast<int32_t>(load_unaligned<int16_t>(values, i));
+        case 4:
+            return static_cast<int32_t>(values[i]);
+        case 5:
+            return static_cast<int32_t>((values[i / 8] >> (i % 8)) & 1U);
+        case 6:
+            return load_scaled<3>(values, i);
+        case 7:
+            return load_unaligned<std::array<float, 3>>(values, i);
+        case 8:
+            return load_scaled<2>(values, i);
+        case 9:
+            return load_unaligned<std::array<float, 2>>(values, i);
+        case 10:
+            return load_scaled<4>(values, i);
+        case 11:
+            return load_unaligned<std::array<float, 4>>(values, i);
+        case 12: {
+            auto const offset = load_unaligned<uint16_t>(values, i);
+            if(offset > strings_size) {
+                return nullptr;
+            }
+            auto const str = strings + offset;
+            auto const end = static_cast<char const*>(memchr(str, '\0', strings_size - offset));
+            return std::string(str, end ? end : strings + strings_size);
+        }
+        }
+    }
+    return nullptr;
+}
+
+bool IniView::contains(IniHash h) const noexcept {
+    for(size_t s = 0; s < section_count; s++) {
+        auto const& section = sections[s];
+        if(!section.count) {
+            continue;
+        }
+        if(auto const found = find(section, h); found >= 0) {
+            // get() reads strings past the table as null
+            return s != 12 || load_unaligned<uint16_t>(section.values, static_cast<size_t>(found))
+                    <= strings_size;
+        }
+    }
+    return false;
+}
+
+void IniView::hashes(std::vector<uint32_t>& out) const noexcept {
+    for(auto const& section: sections) {
+        for(size_t i = 0; i < section.count; i++) {
+            out.push_back(load_unaligned<uint32_t>(section.hashes, i));
+        }
+    }
+}
+
+size_t IniView::size() const noexcept {
+    size_t result = 0;
+    for(auto const& section: sections) {
+        result += section.count;
+    }
+    return result;
 }
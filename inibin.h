@@ -2,11 +2,19 @@
 #define INIBIN_H
 #include <unordered_map>
 #include <string>
+#include <string_view>
 #include <array>
+#include <atomic>
 #include <variant>
 #include <optional>
+#include <memory>
+#include <shared_mutex>
 #include <type_traits>
 #include "types.hpp"
+#include "flatmap.hpp"
+#include "bloom.hpp"
+
+struct Pack;
 
 class IniHash {
 private:
@@ -72,21 +80,238 @@ inline IniHash operator*(IniHash const left, std::string const& right) {
     return IniHash(IniHash(left, "*"), right.c_str());
 }
 
+// "*name" half of a section key with its hash worked out at compile time,
+// section * key then only costs a multiply-add instead of hashing name
+class IniKey {
+private:
+    std::uint32_t mult;
+    std::uint32_t hash;
+
+    constexpr inline static uint32_t
+    power(char const* str, uint32_t result) {
+        return *str ? power(str + 1, result * 65599U) : result;
+    }
+
+    constexpr inline IniKey(uint32_t mult, uint32_t hash) noexcept
+        : mult(mult), hash(hash) {}
+
+    constexpr inline IniKey append(char const* str) const noexcept {
+        return { power(str, mult), IniHash(hash, str) };
+    }
+
+    constexpr inline IniKey append(uint32_t number) const noexcept {
+        char digits[11] = {};
+        size_t count = 0;
+        do {
+            digits[count++] = static_cast<char>('0' + number % 10);
+            number /= 10;
+        } while(number);
+        char str[11] = {};
+        for(size_t i = 0; i < count; i++) {
+            str[i] = digits[count - 1 - i];
+        }
+        return append(str);
+    }
+public:
+    constexpr inline IniKey(char const* name) noexcept
+        : mult(power(name, 65599U)), hash(IniHash(IniHash("*"), name)) {}
+
+    // prefix, index in decimal and then suffix, for numbered keys
+    // such as "GroupPart3Type"
+    constexpr inline IniKey(char const* prefix, uint32_t index, char const* suffix = "") noexcept
+        : IniKey(IniKey(prefix).append(index).append(suffix)) {}
+
+    friend constexpr inline IniHash operator*(IniHash const left, IniKey const right) noexcept {
+        return static_cast<uint32_t>(left) * right.mult + right.hash;
+    }
+};
+
 template<>
 struct std::hash<IniHash> : public std::hash<uint32_t> {};
 
+using IniValue = std::variant<std::nullptr_t,
+                             int32_t,
+                             float,
+                             std::array<float, 2>,
+                             std::array<float, 3>,
+                             std::array<float, 4>,
+                             std::string>;
+
+// Answers lookups straight from the section arrays of a v2 inibin in memory,
+// nothing is copied. Data must outlive the view.
+class IniView {
+public:
+    inline constexpr static size_t section_count = 13;
+
+    struct Section {
+        uint8_t const* hashes = nullptr;
+        uint8_t const* values = nullptr;
+        uint32_t count = 0;
+        bool sorted = true;
+        // built by load when hashes are not sorted
+        std::vector<uint16_t> order = {};
+    };
+private:
+    std::array<Section, section_count> sections = {};
+    char const* strings = nullptr;
+    size_t strings_size = 0;
+
+    int32_t find(Section const& section, uint32_t h) const noexcept;
+public:
+    int load(uint8_t const* data, size_t size) noexcept;
+
+    IniValue get(IniHash h) const noexcept;
+
+    // Same as get(h) holding a value, without decoding it
+    bool contains(IniHash h) const noexcept;
+
+    // raw entry count, hashes repeated across sections count every time
+    size_t size() const noexcept;
+
+    // Appends hashes of all entries, duplicates included
+    void hashes(std::vector<uint32_t>& out) const noexcept;
+};
+
 class Ini {
 public:
-    using IniValue = std::variant<std::nullptr_t,
-                                 int32_t,
-                                 float,
-                                 std::array<float, 2>,
-                                 std::array<float, 3>,
-                                 std::array<float, 4>,
-                                 std::string>;
-    using IniMap = std::unordered_map<IniHash, IniValue>;
+    using IniValue = ::IniValue;
+    // Values are kept in one dense array per type, the map only holds
+    // (index << 3 | IniValue::index()) of the value, 0 hides an entry of
+    // the view or base
+    using IniMap = FlatMap<IniHash, uint32_t>;
+
+    // Counts lookups of get, get_batch and get_floats, hits are
+    // lookups - rejected - false_positives
+    struct LookupStats {
+        uint64_t lookups = 0;
+        // turned away by the presence filter without touching the map
+        uint64_t rejected = 0;
+        // passed the filter but were not there
+        uint64_t false_positives = 0;
+    };
 private:
     IniMap values;
+    std::vector<int32_t> ints;
+    std::vector<float> floats;
+    std::vector<std::array<float, 2>> vec2s;
+    std::vector<std::array<float, 3>> vec3s;
+    std::vector<std::array<float, 4>> vec4s;
+    // null terminated, indexed by offset
+    std::vector<char> strings;
+    // set by from_view, queried when values has no entry
+    std::optional<IniView> view;
+    // bytes behind view when loaded lazily, shared so copies stay valid
+    std::shared_ptr<std::vector<uint8_t> const> view_data;
+    // set by from_base, queried after values and view, never modified
+    std::shared_ptr<Ini const> base;
+    // over values and view hashes, rejects most misses without a probe,
+    // base has its own
+    PresenceFilter filter;
+    // relaxed atomics so readers on several threads may count at once,
+    // a copy starts from the counts of the original
+    struct LookupCounters {
+        bool enabled = false;
+        std::atomic<uint64_t> lookups = 0;
+        std::atomic<uint64_t> rejected = 0;
+        std::atomic<uint64_t> false_positives = 0;
+        LookupCounters() noexcept = default;
+        LookupCounters(LookupCounters const& other) noexcept {
+            *this = other;
+        }
+        inline LookupCounters& operator=(LookupCounters const& other) noexcept {
+            enabled = other.enabled;
+            lookups.store(other.lookups.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            rejected.store(other.rejected.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            false_positives.store(other.false_positives.load(std::memory_order_relaxed),
+                                  std::memory_order_relaxed);
+            return *this;
+        }
+    };
+    mutable LookupCounters stats;
+    // guards parsed and parsed_floats against concurrent get_floats,
+    // a copy gets a lock of its own
+    struct ParsedLock {
+        std::shared_mutex mutex;
+        ParsedLock() noexcept = default;
+        ParsedLock(ParsedLock const&) noexcept {}
+        inline ParsedLock& operator=(ParsedLock const&) noexcept { return *this; }
+    };
+    mutable ParsedLock parsed_lock;
+    // numbers parsed out of string values by get_floats,
+    // (index << 3 | count) into parsed_floats
+    mutable FlatMap<IniHash, uint32_t> parsed;
+    mutable std::vector<float> parsed_floats;
+
+    IniValue load(uint32_t ref) const noexcept;
+
+    // Looks h up in this layer and then base, probed is set once a filter
+    // lets h through. Leaves stats alone so a shared base is never written.
+    IniValue find(IniHash h, bool& probed) const noexcept;
+
+    inline IniValue find_base(IniHash h, bool& probed) const noexcept {
+        return base ? base->find(h, probed) : nullptr;
+    }
+
+    inline void count_lookup(bool found, bool probed) const noexcept {
+        if(!stats.enabled) {
+            return;
+        }
+        stats.lookups.fetch_add(1, std::memory_order_relaxed);
+        if(!found) {
+            (probed ? stats.false_positives : stats.rejected).fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // entries of this layer alone
+    inline size_t layer_size() const noexcept {
+        return values.size() + (view ? view->size() : 0);
+    }
+
+    void rebuild_filter() noexcept;
+
+    inline void filter_insert(IniHash h) noexcept {
+        if(layer_size() > filter.capacity()) {
+            rebuild_filter();
+        } else {
+            filter.insert(h);
+        }
+    }
+
+    inline static uint32_t make_ref(size_t type, size_t index) noexcept {
+        return static_cast<uint32_t>(index << 3 | type);
+    }
+
+    inline uint32_t store(int32_t v) {
+        ints.push_back(v);
+        return make_ref(1, ints.size() - 1);
+    }
+
+    inline uint32_t store(float v) {
+        floats.push_back(v);
+        return make_ref(2, floats.size() - 1);
+    }
+
+    inline uint32_t store(std::array<float, 2> const& v) {
+        vec2s.push_back(v);
+        return make_ref(3, vec2s.size() - 1);
+    }
+
+    inline uint32_t store(std::array<float, 3> const& v) {
+        vec3s.push_back(v);
+        return make_ref(4, vec3s.size() - 1);
+    }
+
+    inline uint32_t store(std::array<float, 4> const& v) {
+        vec4s.push_back(v);
+        return make_ref(5, vec4s.size() - 1);
+    }
+
+    inline uint32_t store(std::string_view v) {
+        auto const offset = strings.size();
+        strings.insert(strings.end(), v.begin(), v.end());
+        strings.push_back('\0');
+        return make_ref(6, offset);
+    }
 
     class ConstReference {
     private:
@@ -173,7 +398,41 @@ private:
     };
 
 public:
-    int from_file(char const* filename) noexcept;
+    // Lazy keeps the file bytes and decodes an entry only when it is
+    // queried, for callers that read a handful of keys
+    int from_file(char const* filename, bool lazy = false) noexcept;
+
+    int from_memory(uint8_t const* data, size_t size) noexcept;
+
+    // Stored entries are parsed out of the mapping, compressed ones
+    // decompress block by block as the sections are read
+    int from_pack(Pack const& pack, char const* path) noexcept;
+
+    // Looks values up in the raw inibin instead of decoding it, data must
+    // outlive the Ini. Iteration only covers values set() afterwards.
+    int from_view(uint8_t const* data, size_t size) noexcept;
+
+    // Starts an empty layer on top of base, set() only records what changed
+    // and lookups fall through to base. Iteration only covers this layer.
+    // The base is shared between layers and must not be modified.
+    int from_base(std::shared_ptr<Ini const> base) noexcept;
+
+    // Copy of base with this layer applied, layers under base stay shared.
+    // Returns a plain copy when there is no base.
+    Ini flatten() const noexcept;
+
+    // Appends hashes of all entries of every layer, duplicates and erased
+    // entries included
+    void hashes(std::vector<uint32_t>& out) const noexcept;
+
+    // Writes all values as a v2 inibin, each value goes to the smallest
+    // section that reads back bit exact.
+    // With bake, strings holding only 1 to 4 numbers are stored as
+    // int/float/vector instead. Readers asking for such a key as string or
+    // bool then see the formatted number instead of the original text.
+    int to_memory(std::vector<uint8_t>& out, bool bake = false) const noexcept;
+
+    int to_file(char const* filename, bool bake = false) const noexcept;
 
     auto begin() const& { return ConstIterator{ *this, values.begin() }; }
     auto end() const& { return ConstIterator{ *this, values.end() }; }
@@ -189,30 +448,155 @@ public:
         return {*this, h};
     }
 
-    inline void clear() noexcept { values.clear(); }
+    inline void clear() noexcept {
+        values.clear();
+        ints.clear();
+        floats.clear();
+        vec2s.clear();
+        vec3s.clear();
+        vec4s.clear();
+        strings.clear();
+        view.reset();
+        view_data.reset();
+        base.reset();
+        filter.clear();
+        parsed.clear();
+        parsed_floats.clear();
+    }
 
     inline void reserve(size_t size) { values.reserve(size); }
 
-    inline size_t size() const noexcept { return values.size(); }
+    // counts every layer, keys present in more than one count every time
+    inline size_t size() const noexcept {
+        return layer_size() + (base ? base->size() : 0);
+    }
 
     IniValue get(IniHash h) const noexcept;
 
+    // Same as get(h) holding a value, without building it or counting a lookup
+    bool contains(IniHash h) const noexcept;
+
+    // Reads up to count floats from the value at h, numbers and vectors are
+    // copied, strings are parsed on first use and the result is remembered.
+    // Returns how many floats were read or -1 when h is missing.
+    // Safe to call on the same Ini from multiple threads, the remembered
+    // numbers are behind a lock.
+    int get_floats(IniHash h, float* out, size_t count) const noexcept;
+
+    // Resolves count keys in one pass, out[i] is null when keys[i] is missing
+    void get_batch(IniHash const* keys, size_t count, IniValue* out) const noexcept;
+
+    // Overwritten or erased values stay in their array until clear()
     void set(IniHash h, IniValue v) noexcept;
+
+    // Inserts only if h is not present yet
+    template<typename T>
+    inline bool try_emplace(IniHash h, T const& value) {
+        auto const [i, inserted] = values.try_emplace(h, 0u);
+        if(inserted) {
+            i->second = store(value);
+            filter_insert(h);
+        }
+        return inserted;
+    }
+
+    // Counts of lookups that finished so far, the three are read one after
+    // another and may be off by lookups running on other threads.
+    // Lookups that fall through to base are counted here, not in base.
+    inline LookupStats lookup_stats() const noexcept {
+        return {
+            stats.lookups.load(std::memory_order_relaxed),
+            stats.rejected.load(std::memory_order_relaxed),
+            stats.false_positives.load(std::memory_order_relaxed)
+        };
+    }
+
+    // Counting is off until enabled, it costs an atomic add per lookup
+    inline void enable_lookup_stats(bool enable = true) noexcept { stats.enabled = enable; }
+
+    // Keeps counting enabled or not
+    inline void reset_lookup_stats() noexcept {
+        auto const enabled = stats.enabled;
+        stats = {};
+        stats.enabled = enabled;
+    }
 };
 
-extern bool ini_get(Ini const& ini, IniHash h, int32_t& val) noexcept;
+extern bool ini_get(IniValue const& value, int32_t& val) noexcept;
+
+extern bool ini_get(IniValue const& value, bool& val) noexcept;
+
+extern bool ini_get(IniValue const& value, float& val) noexcept;
+
+extern bool ini_get(IniValue const& value, std::string& val) noexcept;
+
+extern bool ini_get(IniValue const& value, std::array<float, 2>& val) noexcept;
+
+extern bool ini_get(IniValue const& value, std::array<float, 3>& val) noexcept;
+
+extern bool ini_get(IniValue const& value, std::array<float, 4>& val) noexcept;
+
+inline bool ini_get(IniValue const& value, uint32_t& val) noexcept {
+    return ini_get(value, reinterpret_cast<int32_t&>(val));
+}
+
+inline bool ini_get(IniValue const& value, Vec2& val) noexcept {
+    return ini_get(value, reinterpret_cast<std::array<float, 2> &>(val));
+}
+
+inline bool ini_get(IniValue const& value, Vec3& val) noexcept {
+    return ini_get(value, reinterpret_cast<std::array<float, 3> &>(val));
+}
 
-extern bool ini_get(Ini const& ini, IniHash h, bool& val) noexcept;
+inline bool ini_get(IniValue const& value, Vec4& val) noexcept {
+    return ini_get(value, reinterpret_cast<std::array<float, 4> &>(val));
+}
 
-extern bool ini_get(Ini const& ini, IniHash h, float& val) noexcept;
+inline bool ini_get(IniValue const& value, ColorF& val) noexcept {
+    return ini_get(value, reinterpret_cast<std::array<float, 4> &>(val));
+}
 
-extern bool ini_get(Ini const& ini, IniHash h, std::string& val) noexcept;
+template<typename T>
+inline std::enable_if_t<std::is_enum_v<T>, bool>
+ini_get(IniValue const& value, T& val) noexcept {
+    if constexpr(sizeof(T) == sizeof(int32_t)) {
+        return ini_get(value, reinterpret_cast<int32_t&>(val));
+    } else {
+        if(int32_t r = {}; ini_get(value, r)) {
+            val = static_cast<T>(r);
+            return true;
+        }
+        return false;
+    }
+}
 
-extern bool ini_get(Ini const& ini, IniHash h, std::array<float, 2>& val) noexcept;
+inline bool ini_get(Ini const& ini, IniHash h, int32_t& val) noexcept {
+    return ini_get(ini.get(h), val);
+}
 
-extern bool ini_get(Ini const& ini, IniHash h, std::array<float, 3>& val) noexcept;
+inline bool ini_get(Ini const& ini, IniHash h, bool& val) noexcept {
+    return ini_get(ini.get(h), val);
+}
 
-extern bool ini_get(Ini const& ini, IniHash h, std::array<float, 4>& val) noexcept;
+inline bool ini_get(Ini const& ini, IniHash h, float& val) noexcept {
+    return ini_get(ini.get(h), val);
+}
+
+inline bool ini_get(Ini const& ini, IniHash h, std::string& val) noexcept {
+    return ini_get(ini.get(h), val);
+}
+
+inline bool ini_get(Ini const& ini, IniHash h, std::array<float, 2>& val) noexcept {
+    return ini_get(ini.get(h), val);
+}
+
+inline bool ini_get(Ini const& ini, IniHash h, std::array<float, 3>& val) noexcept {
+    return ini_get(ini.get(h), val);
+}
+
+inline bool ini_get(Ini const& ini, IniHash h, std::array<float, 4>& val) noexcept {
+    return ini_get(ini.get(h), val);
+}
 
 inline bool ini_get(Ini const& ini, IniHash h, uint32_t& val) noexcept {
     return ini_get(ini, h, reinterpret_cast<int32_t&>(val));
@@ -248,5 +632,28 @@ ini_get(Ini const& ini, IniHash h, T& val) noexcept {
     }
 }
 
+// Output slot for ini_get_batch, value is reset to defval before lookup
+template<typename T>
+struct IniField {
+    IniHash hash;
+    T& value;
+    T defval;
+};
+
+template<typename T, typename D = T>
+inline IniField<T> ini_field(IniHash h, T& value, D const& defval = D{}) noexcept {
+    return { h, value, static_cast<T>(defval) };
+}
+
+// Same as value = ini[hash].as_or<T>(defval) for each field, but all keys
+// are resolved together with Ini::get_batch
+template<typename...T>
+inline void ini_get_batch(Ini const& ini, IniField<T> const&...fields) noexcept {
+    IniHash const keys[] = { fields.hash... };
+    IniValue values[sizeof...(T)];
+    ini.get_batch(keys, sizeof...(T), values);
+    size_t i = 0;
+    ((fields.value = fields.defval, ini_get(values[i++], fields.value)), ...);
+}
 
 #endif // INIBIN_H
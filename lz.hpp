@@ -0,0 +1,166 @@
+#ifndef LZ_HPP
+#define LZ_HPP
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+
+// Small LZ77 codec using the LZ4 block layout:
+// token (literal length << 4 | match length - 4), extra length bytes,
+// literals, 16 bit little endian offset, extra match length bytes.
+// Last sequence holds literals only.
+namespace LZ {
+    inline constexpr size_t min_match = 4;
+    inline constexpr size_t hash_bits = 12;
+
+    // Worst case compressed size
+    inline constexpr size_t bound(size_t size) noexcept {
+        return size + size / 255 + 16;
+    }
+
+    inline uint32_t read32(uint8_t const* p) noexcept {
+        uint32_t result;
+        memcpy(&result, p, sizeof(result));
+        return result;
+    }
+
+    inline bool write_length(uint8_t*& op, uint8_t const* oend, size_t length) noexcept {
+        for(; length >= 255; length -= 255) {
+            if(op == oend) {
+                return false;
+            }
+            *op++ = 255;
+        }
+        if(op == oend) {
+            return false;
+        }
+        *op++ = static_cast<uint8_t>(length);
+        return true;
+    }
+
+    inline bool write_sequence(uint8_t*& op, uint8_t const* oend,
+                               uint8_t const* literals, size_t literalLength,
+                               size_t offset, size_t matchLength) noexcept {
+        if(op == oend) {
+            return false;
+        }
+        auto& token = *op++;
+        token = static_cast<uint8_t>(std::min<size_t>(literalLength, 15) << 4);
+        if(literalLength >= 15 && !write_length(op, oend, literalLength - 15)) {
+            return false;
+        }
+        if(literalLength > static_cast<size_t>(oend - op)) {
+            return false;
+        }
+        memcpy(op, literals, literalLength);
+        op += literalLength;
+        if(!matchLength) {
+            return true;
+        }
+        if(oend - op < 2) {
+            return false;
+        }
+        *op++ = static_cast<uint8_t>(offset);
+        *op++ = static_cast<uint8_t>(offset >> 8);
+        auto const extra = matchLength - min_match;
+        token |= static_cast<uint8_t>(std::min<size_t>(extra, 15));
+        if(extra >= 15 && !write_length(op, oend, extra - 15)) {
+            return false;
+        }
+        return true;
+    }
+
+    // Returns compressed size or 0 when it doesn't fit in capacity
+    inline size_t compress(uint8_t const* src, size_t size,
+                           uint8_t* dst, size_t capacity) noexcept {
+        auto op = dst;
+        auto const oend = dst + capacity;
+        size_t anchor = 0;
+        // matches must not start in the last 12 bytes or cover the last 5
+        if(size > 12) {
+            std::vector<int64_t> table(size_t{1} << hash_bits, -1);
+            size_t const limit = size - 12;
+            size_t const matchLimit = size - 5;
+            for(size_t ip = 0; ip < limit;) {
+                auto const seq = read32(src + ip);
+                auto const h = (seq * 2654435761u) >> (32 - hash_bits);
+                auto const ref = table[h];
+                table[h] = static_cast<int64_t>(ip);
+                if(ref < 0 || ip - static_cast<size_t>(ref) > 0xFFFF
+                        || read32(src + ref) != seq) {
+                    ip++;
+                    continue;
+                }
+                size_t length = min_match;
+                while(ip + length < matchLimit && src[ref + length] == src[ip + length]) {
+                    length++;
+                }
+                if(!write_sequence(op, oend, src + anchor, ip - anchor,
+                                   ip - static_cast<size_t>(ref), length)) {
+                    return 0;
+                }
+                ip += length;
+                anchor = ip;
+            }
+        }
+        if(!write_sequence(op, oend, src + anchor, size - anchor, 0, 0)) {
+            return 0;
+        }
+        return static_cast<size_t>(op - dst);
+    }
+
+    // Returns decompressed size or -1 on malformed input
+    inline int64_t decompress(uint8_t const* src, size_t size,
+                              uint8_t* dst, size_t capacity) noexcept {
+        size_t ip = 0;
+        size_t op = 0;
+        auto const read_length = [&](size_t& length) {
+            for(uint8_t b = 255; b == 255; length += b) {
+                if(ip == size) {
+                    return false;
+                }
+                b = src[ip++];
+            }
+            return true;
+        };
+        while(ip < size) {
+            auto const token = src[ip++];
+            size_t literalLength = token >> 4;
+            if(literalLength == 15 && !read_length(literalLength)) {
+                return -1;
+            }
+            if(literalLength > size - ip || literalLength > capacity - op) {
+                return -1;
+            }
+            memcpy(dst + op, src + ip, literalLength);
+            ip += literalLength;
+            op += literalLength;
+            if(ip == size) {
+                break;
+            }
+            if(size - ip < 2) {
+                return -1;
+            }
+            size_t const offset = src[ip] | (static_cast<size_t>(src[ip + 1]) << 8);
+            ip += 2;
+            if(offset == 0 || offset > op) {
+                return -1;
+            }
+            size_t matchLength = token & 15;
+            if(matchLength == 15 && !read_length(matchLength)) {
+                return -1;
+            }
+            matchLength += min_match;
+            if(matchLength > capacity - op) {
+                return -1;
+            }
+            // may overlap, copy forward byte by byte
+            for(size_t i = 0; i < matchLength; i++, op++) {
+                dst[op] = dst[op - offset];
+            }
+        }
+        return static_cast<int64_t>(op);
+    }
+}
+
+#endif // LZ_HPP
@@ -21,7 +21,7 @@ int main()
     system.load(ini);
 
     */
-    if(auto file = File::readb("Ashe3/Ashe.skl"); file) {
+    if(auto file = MemoryFile::mapb("Ashe3/Ashe.skl"); file) {
         RitoResource::Skeleton test {};
         test.load(*file);
     }
@@ -0,0 +1,274 @@
+#ifndef PACK_HPP
+#define PACK_HPP
+#include "file.hpp"
+#include "inibin.h"
+#include "lz.hpp"
+#include <array>
+#include <algorithm>
+
+struct PackSource;
+
+// Archive of many asset files, payloads are 16 byte aligned so loaders can
+// parse straight out of the mapping
+struct Pack {
+    inline constexpr static uint32_t version = 1;
+    inline constexpr static size_t alignment = 16;
+
+    struct Header {
+        std::array<char, 4> magic;
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t pad;
+    };
+
+    enum Flags : uint32_t {
+        None,
+        Compressed = 0x01,
+    };
+
+    // sorted by hash, size is always the uncompressed size
+    struct Entry {
+        uint32_t hash;
+        uint32_t flags;
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    // Compressed payloads start with this, followed by blockCount + 1
+    // uint32_t offsets of each compressed block relative to the payload.
+    // Blocks that didn't shrink are stored raw.
+    struct BlockTable {
+        uint32_t blockSize;
+        uint32_t blockCount;
+    };
+
+    std::optional<MemoryFile> archive;
+    Span<Entry> entries;
+
+    // Paths are relative to the packed root, using '/' as separator
+    static inline IniHash hash_path(char const* path) noexcept {
+        return IniHash(path);
+    }
+
+    int load(char const* name) noexcept {
+        archive.reset();
+        entries = {};
+        if(auto mapped = MemoryFile::mapb(name); mapped) {
+            archive.emplace(std::move(*mapped));
+        } else {
+            return -1;
+        }
+        Header header;
+        if(!archive->read(header)) {
+            return -2;
+        }
+        if(header.magic != std::array{'T', 'P', 'A', 'K'} || header.version != version) {
+            return -3;
+        }
+        if(!archive->view(entries, header.entryCount)) {
+            return -4;
+        }
+        for(auto const& entry: entries) {
+            if(entry.offset > archive->end) {
+                return -5;
+            }
+            if(!(entry.flags & Flags::Compressed) && entry.size > archive->end - entry.offset) {
+                return -6;
+            }
+        }
+        return 0;
+    }
+
+    inline Entry const* find(IniHash h) const noexcept {
+        auto const i = std::lower_bound(entries.begin(), entries.end(), uint32_t{h},
+                                        [](Entry const& e, uint32_t h) {
+            return e.hash < h;
+        });
+        if(i == entries.end() || i->hash != h) {
+            return nullptr;
+        }
+        return i;
+    }
+
+    // Reads size bytes at offset of the uncompressed entry,
+    // only the blocks overlapping the range are decompressed
+    bool read(Entry const& entry, uint64_t offset,
+              uint8_t* out, size_t size) const noexcept {
+        if(offset > entry.size || size > entry.size - offset) {
+            return false;
+        }
+        auto const payload = archive->map + entry.offset;
+        if(!(entry.flags & Flags::Compressed)) {
+            memcpy(out, payload + offset, size);
+            return true;
+        }
+        auto const available = archive->end - entry.offset;
+        BlockTable table;
+        if(available < sizeof(table)) {
+            return false;
+        }
+        memcpy(&table, payload, sizeof(table));
+        if(!table.blockSize
+                || table.blockCount != (entry.size + table.blockSize - 1) / table.blockSize
+                || (table.blockCount + 1ull) * sizeof(uint32_t) > available - sizeof(table)) {
+            return false;
+        }
+        auto const offsets = reinterpret_cast<uint32_t const*>(payload + sizeof(table));
+        std::vector<uint8_t> scratch;
+        for(uint64_t b = offset / table.blockSize; size; b++) {
+            auto const blockBeg = b * table.blockSize;
+            auto const blockSize = std::min<uint64_t>(table.blockSize, entry.size - blockBeg);
+            auto const from = offset - blockBeg;
+            auto const count = static_cast<size_t>(std::min<uint64_t>(blockSize - from, size));
+            auto const srcBeg = offsets[b];
+            auto const srcEnd = offsets[b + 1];
+            if(srcBeg > srcEnd || srcEnd > available) {
+                return false;
+            }
+            auto const src = payload + srcBeg;
+            auto const srcSize = srcEnd - srcBeg;
+            if(srcSize >= blockSize) {
+                if(srcSize != blockSize) {
+                    return false;
+                }
+                memcpy(out, src + from, count);
+            } else if(count == blockSize) {
+                if(LZ::decompress(src, srcSize, out, count) != static_cast<int64_t>(count)) {
+                    return false;
+                }
+            } else {
+                scratch.resize(blockSize);
+                if(LZ::decompress(src, srcSize, scratch.data(), scratch.size())
+                        != static_cast<int64_t>(blockSize)) {
+                    return false;
+                }
+                memcpy(out, scratch.data() + from, count);
+            }
+            out += count;
+            offset += count;
+            size -= count;
+        }
+        return true;
+    }
+
+    // File is a view into the archive, Pack must outlive it.
+    // Only for stored entries, compressed ones go through stream()
+    inline std::optional<MemoryFile> open(IniHash h) const noexcept {
+        auto const entry = find(h);
+        if(!entry || (entry->flags & Flags::Compressed)) {
+            return std::nullopt;
+        }
+        return MemoryFile::from_memory(archive->map + entry->offset, entry->size);
+    }
+
+    inline std::optional<MemoryFile> open(char const* path) const noexcept {
+        return open(hash_path(path));
+    }
+
+    // File reads any entry through read(), compressed blocks are only
+    // decompressed once they are accessed, Pack must outlive it
+    inline std::optional<BasicFile<PackSource>> stream(IniHash h) const noexcept;
+
+    inline std::optional<BasicFile<PackSource>> stream(char const* path) const noexcept;
+};
+
+// Pack entry source, stored entries read straight from the archive, for
+// compressed ones the block holding the read is decompressed and kept
+// so consecutive small reads don't decompress it again
+struct PackSource {
+    inline constexpr static bool in_memory = false;
+
+    Pack const* pack;
+    Pack::Entry const* entry;
+    size_t end;
+    mutable size_t pos;
+    // 0 for stored entries
+    size_t block_size;
+    mutable std::vector<uint8_t> block;
+    mutable size_t block_beg;
+
+    inline PackSource(Pack const* pack, Pack::Entry const* entry, size_t block_size) noexcept
+        : pack(pack), entry(entry), end(static_cast<size_t>(entry->size)), pos(0),
+          block_size(block_size), block(), block_beg(0) {}
+    PackSource(PackSource && other) noexcept
+        : pack(other.pack), entry(other.entry), end(other.end), pos(other.pos),
+          block_size(other.block_size), block(std::move(other.block)),
+          block_beg(other.block_beg) {
+        other.end = 0;
+        other.pos = 0;
+        other.block.clear();
+    }
+    PackSource(PackSource const&) = delete;
+    void operator=(PackSource const&) = delete;
+    void operator=(PackSource &&) = delete;
+
+    // Returns pointer to size contiguous bytes at pos and advances past them,
+    // nullptr when out of bounds or the range spans two blocks
+    inline uint8_t const* fetch(size_t size) const noexcept {
+        if(size > end - pos) {
+            return nullptr;
+        }
+        if(!block_size) {
+            auto const result = pack->archive->map + entry->offset + pos;
+            pos += size;
+            return result;
+        }
+        if(pos < block_beg || pos + size > block_beg + block.size()) {
+            auto const beg = pos / block_size * block_size;
+            auto const len = std::min(block_size, end - beg);
+            if(pos + size > beg + len) {
+                return nullptr;
+            }
+            block.resize(len);
+            if(!pack->read(*entry, beg, block.data(), len)) {
+                block.clear();
+                return nullptr;
+            }
+            block_beg = beg;
+        }
+        auto const result = block.data() + (pos - block_beg);
+        pos += size;
+        return result;
+    }
+
+    inline bool read_bytes(void* data, size_t size) const noexcept {
+        if(auto const src = fetch(size); src) {
+            memcpy(data, src, size);
+            return true;
+        }
+        // spans blocks, decompress the range straight into data
+        if(size > end - pos || !pack->read(*entry, pos, static_cast<uint8_t*>(data), size)) {
+            return false;
+        }
+        pos += size;
+        return true;
+    }
+};
+
+using PackFile = BasicFile<PackSource>;
+
+inline std::optional<PackFile> Pack::stream(IniHash h) const noexcept {
+    auto const entry = find(h);
+    if(!entry) {
+        return std::nullopt;
+    }
+    size_t block_size = 0;
+    if(entry->flags & Flags::Compressed) {
+        BlockTable table;
+        if(archive->end - entry->offset < sizeof(table)) {
+            return std::nullopt;
+        }
+        memcpy(&table, archive->map + entry->offset, sizeof(table));
+        if(!table.blockSize) {
+            return std::nullopt;
+        }
+        block_size = table.blockSize;
+    }
+    return PackFile(this, entry, block_size);
+}
+
+inline std::optional<PackFile> Pack::stream(char const* path) const noexcept {
+    return stream(hash_path(path));
+}
+
+#endif // PACK_HPP
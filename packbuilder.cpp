@@ -0,0 +1,180 @@
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "pack.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+constexpr size_t block_size = 64 * 1024;
+
+struct Input {
+    fs::path path;
+    std::string name;
+    Pack::Entry entry;
+};
+
+bool is_asset(fs::path const& path) noexcept {
+    auto ext = path.extension().string();
+    for(auto& c: ext) {
+        c = static_cast<char>(c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c);
+    }
+    return ext == ".troybin" || ext == ".skn" || ext == ".skl"
+            || ext == ".anm" || ext == ".nvr";
+}
+
+// Splits data in blocks and compresses each, blocks that don't shrink are stored raw
+void compress_blocks(std::vector<uint8_t> const& data, std::vector<uint8_t>& out) noexcept {
+    Pack::BlockTable const table = {
+        static_cast<uint32_t>(block_size),
+        static_cast<uint32_t>((data.size() + block_size - 1) / block_size)
+    };
+    std::vector<uint32_t> offsets;
+    offsets.reserve(table.blockCount + 1);
+    out.resize(sizeof(table) + (table.blockCount + 1) * sizeof(uint32_t));
+    std::vector<uint8_t> block(LZ::bound(block_size));
+    for(size_t beg = 0; beg < data.size(); beg += block_size) {
+        auto const size = std::min(block_size, data.size() - beg);
+        offsets.push_back(static_cast<uint32_t>(out.size()));
+        auto const packed = LZ::compress(data.data() + beg, size, block.data(), block.size());
+        if(packed && packed < size) {
+            out.insert(out.end(), block.begin(), block.begin() + static_cast<ptrdiff_t>(packed));
+        } else {
+            out.insert(out.end(), data.begin() + static_cast<ptrdiff_t>(beg),
+                       data.begin() + static_cast<ptrdiff_t>(beg + size));
+        }
+    }
+    offsets.push_back(static_cast<uint32_t>(out.size()));
+    memcpy(out.data(), &table, sizeof(table));
+    memcpy(out.data() + sizeof(table), offsets.data(), offsets.size() * sizeof(uint32_t));
+}
+
+int write_pack(char const* out, std::vector<Input>& inputs, bool compress) noexcept {
+    std::sort(inputs.begin(), inputs.end(), [](Input const& l, Input const& r) {
+        return l.entry.hash < r.entry.hash;
+    });
+    for(size_t i = 1; i < inputs.size(); i++) {
+        if(inputs[i].entry.hash == inputs[i - 1].entry.hash) {
+            fprintf(stderr, "hash collision: %s %s\n",
+                    inputs[i - 1].name.c_str(), inputs[i].name.c_str());
+            return -1;
+        }
+    }
+
+    FILE* f = nullptr;
+    if(fopen_s(&f, out, "wb") || !f) {
+        return -2;
+    }
+    static uint8_t const zeros[Pack::alignment] = {};
+    auto const pad = [f](uint64_t pos) {
+        auto const padding = (Pack::alignment - pos % Pack::alignment) % Pack::alignment;
+        fwrite(zeros, 1, padding, f);
+        return pos + padding;
+    };
+
+    // payloads first, header and entry table are filled in once offsets are known
+    uint64_t pos = sizeof(Pack::Header) + inputs.size() * sizeof(Pack::Entry);
+    if(seek64(f, pos)) {
+        fclose(f);
+        return -2;
+    }
+
+    std::vector<uint8_t> data;
+    std::vector<uint8_t> packed;
+    for(auto& input: inputs) {
+        pos = pad(pos);
+        auto const file = StdioFile::readb(input.path.string().c_str(), 0);
+        if(!file || !file->read(data, input.entry.size)) {
+            fprintf(stderr, "failed to read: %s\n", input.name.c_str());
+            fclose(f);
+            return -3;
+        }
+        input.entry.offset = pos;
+        if(compress) {
+            compress_blocks(data, packed);
+            if(packed.size() < data.size()) {
+                input.entry.flags |= Pack::Flags::Compressed;
+                fwrite(packed.data(), 1, packed.size(), f);
+                pos += packed.size();
+                continue;
+            }
+        }
+        fwrite(data.data(), 1, data.size(), f);
+        pos += data.size();
+    }
+
+    Pack::Header const header = {
+        {'T', 'P', 'A', 'K'},
+        Pack::version,
+        static_cast<uint32_t>(inputs.size()),
+        0
+    };
+    if(seek64(f, 0)) {
+        fclose(f);
+        return -4;
+    }
+    fwrite(&header, sizeof(header), 1, f);
+    for(auto const& input: inputs) {
+        fwrite(&input.entry, sizeof(input.entry), 1, f);
+    }
+    if(ferror(f)) {
+        fclose(f);
+        return -4;
+    }
+    if(fclose(f)) {
+        return -4;
+    }
+    return 0;
+}
+}
+
+int main(int argc, char** argv) {
+    bool compress = false;
+    if(argc > 1 && std::string(argv[1]) == "-c") {
+        compress = true;
+        argv++;
+        argc--;
+    }
+    if(argc < 3) {
+        fprintf(stderr, "usage: %s [-c] <out.pack> <asset dir>\n", argv[0]);
+        return 1;
+    }
+    fs::path const root = argv[2];
+    std::vector<Input> inputs;
+    std::error_code ec;
+    // increment(ec) instead of operator++, which throws
+    for(fs::recursive_directory_iterator it(root, ec), end; !ec && it != end; it.increment(ec)) {
+        auto const regular = it->is_regular_file(ec);
+        if(ec) {
+            break;
+        }
+        if(!regular || !is_asset(it->path())) {
+            continue;
+        }
+        auto const size = it->file_size(ec);
+        if(ec) {
+            break;
+        }
+        auto name = fs::relative(it->path(), root, ec).generic_string();
+        if(ec) {
+            break;
+        }
+        auto const hash = Pack::hash_path(name.c_str());
+        inputs.push_back(Input {
+                             it->path(),
+                             std::move(name),
+                             Pack::Entry { hash, 0, 0, size }
+                         });
+    }
+    if(ec) {
+        fprintf(stderr, "failed to list: %s\n", argv[2]);
+        return 1;
+    }
+    if(auto r = write_pack(argv[1], inputs, compress); r) {
+        fprintf(stderr, "failed to write pack: %d\n", r);
+        return 1;
+    }
+    printf("packed %zu files\n", inputs.size());
+    return 0;
+}
@@ -0,0 +1,221 @@
+#include "cache.h"
+#include "../file.hpp"
+#include "../paths.hpp"
+#include "../prefetch.hpp"
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+RitoParticle::DefinitionCache::Handle build(Ini const& ini) {
+    auto system = std::make_shared<RitoParticle::System>();
+    if(!system->load(ini)) {
+        return nullptr;
+    }
+    return system;
+}
+
+RitoParticle::DefinitionCache::Handle parse(fs::path const& path) {
+    Ini ini{};
+    if(ini.from_file(path.string().c_str())) {
+        return nullptr;
+    }
+    return build(ini);
+}
+
+RitoParticle::DefinitionCache::Handle parse(std::vector<uint8_t> const& data) {
+    Ini ini{};
+    if(ini.from_memory(data.data(), data.size())) {
+        return nullptr;
+    }
+    return build(ini);
+}
+
+// Calls job(i) for every i below count on up to threads threads,
+// returns how many calls returned false
+template<typename Job>
+size_t run_parallel(size_t count, size_t threads, Job const& job) {
+    threads = std::min(threads, count);
+    std::atomic<size_t> next = 0;
+    std::atomic<size_t> failed = 0;
+    auto const worker = [count, &job, &next, &failed] {
+        for(size_t i = next++; i < count; i = next++) {
+            if(!job(i)) {
+                failed++;
+            }
+        }
+    };
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for(size_t t = 0; t < threads; t++) {
+        workers.emplace_back(worker);
+    }
+    for(auto& w: workers) {
+        w.join();
+    }
+    return failed;
+}
+}
+
+RitoParticle::DefinitionCache& RitoParticle::DefinitionCache::global() noexcept {
+    static DefinitionCache cache;
+    return cache;
+}
+
+RitoParticle::DefinitionCache::Handle
+RitoParticle::DefinitionCache::insert(IniHash h, Handle handle) {
+    std::unique_lock lock(mutex);
+    return systems.try_emplace(h, std::move(handle)).first->second;
+}
+
+size_t RitoParticle::DefinitionCache::load_tree(char const* root, size_t threads) {
+    struct Job {
+        fs::path path;
+        IniHash hash;
+    };
+    std::vector<Job> jobs;
+    size_t failed = 0;
+    // a listing error keeps what was found up to there
+    for_each_file(root, [this, root, &jobs, &failed](fs::path const& path) {
+        if(!is_troybin(path)) {
+            return;
+        }
+        std::error_code ec;
+        auto const name = fs::relative(path, root, ec).generic_string();
+        if(ec) {
+            failed++;
+            return;
+        }
+        if(auto const h = hash_path(name.c_str()); !find(h)) {
+            jobs.push_back({ path, h });
+        }
+    });
+    {
+        std::unique_lock lock(mutex);
+        this->root = root;
+        systems.reserve(systems.size() + jobs.size());
+    }
+    if(jobs.empty()) {
+        return failed;
+    }
+
+    if(!threads) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // a batch is read on all threads first and then parsed out of memory,
+    // its buffers go back to the pool for the next one
+    constexpr size_t batch = 256;
+    Prefetcher prefetcher;
+    std::vector<std::string> paths;
+    for(size_t beg = 0; beg < jobs.size(); beg += batch) {
+        auto const count = std::min(batch, jobs.size() - beg);
+        paths.clear();
+        for(size_t i = 0; i < count; i++) {
+            paths.push_back(jobs[beg + i].path.string());
+        }
+        prefetcher.load(paths, threads);
+        failed += run_parallel(count, threads, [this, &jobs, &prefetcher, beg](size_t i) {
+            auto const& entry = prefetcher.entries[i];
+            if(!entry.good) {
+                return false;
+            }
+            auto handle = parse(entry.data);
+            if(!handle) {
+                return false;
+            }
+            insert(jobs[beg + i].hash, std::move(handle));
+            return true;
+        });
+    }
+    return failed;
+}
+
+RitoParticle::DefinitionCache::Handle RitoParticle::DefinitionCache::get(char const* path) {
+    auto const h = hash_path(path);
+    if(auto handle = find(h); handle) {
+        return handle;
+    }
+    fs::path file;
+    {
+        std::shared_lock lock(mutex);
+        file = fs::path(root) / path;
+    }
+    if(auto handle = parse(file); handle) {
+        return insert(h, std::move(handle));
+    }
+    return nullptr;
+}
+
+RitoParticle::DefinitionCache::Handle
+RitoParticle::DefinitionCache::find(IniHash h) const noexcept {
+    std::shared_lock lock(mutex);
+    if(auto const i = systems.find(h); i != systems.end()) {
+        return i->second;
+    }
+    return nullptr;
+}
+
+size_t RitoParticle::DefinitionCache::size() const noexcept {
+    std::shared_lock lock(mutex);
+    return systems.size();
+}
+
+void RitoParticle::DefinitionCache::clear() noexcept {
+    std::unique_lock lock(mutex);
+    systems.clear();
+}
+
+RitoParticle::Snapshot::CurveReport RitoParticle::DefinitionCache::curve_report(float max_error) const noexcept {
+    std::shared_lock lock(mutex);
+    std::vector<Snapshot::Entry> entries;
+    entries.reserve(systems.size());
+    for(auto const& entry: systems) {
+        entries.emplace_back(entry.first, entry.second.get());
+    }
+    return Snapshot::measure_curves(entries.data(), entries.size(), max_error);
+}
+
+int RitoParticle::DefinitionCache::save(char const* filename) const noexcept {
+    std::vector<uint8_t> data;
+    {
+        std::shared_lock lock(mutex);
+        std::vector<Snapshot::Entry> entries;
+        entries.reserve(systems.size());
+        for(auto const& entry: systems) {
+            entries.emplace_back(entry.first, entry.second.get());
+        }
+        Snapshot::write(data, entries.data(), entries.size());
+    }
+    FILE* f = nullptr;
+    if(fopen_s(&f, filename, "wb") || !f) {
+        return -1;
+    }
+    auto const written = fwrite(data.data(), 1, data.size(), f);
+    if(fclose(f) || written != data.size()) {
+        return -2;
+    }
+    return 0;
+}
+
+int RitoParticle::DefinitionCache::load_snapshot(char const* filename) noexcept {
+    auto const file = MemoryFile::mapb(filename);
+    if(!file) {
+        return -1;
+    }
+    std::vector<std::pair<IniHash, System>> loaded;
+    if(auto r = Snapshot::read(file->map, file->end, loaded); r) {
+        return r - 1;
+    }
+    std::unique_lock lock(mutex);
+    systems.reserve(systems.size() + loaded.size());
+    for(auto& entry: loaded) {
+        systems.try_emplace(entry.first, std::make_shared<System const>(std::move(entry.second)));
+    }
+    return 0;
+}
@@ -0,0 +1,66 @@
+#ifndef PARTICLE_CACHE_H
+#define PARTICLE_CACHE_H
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include "system.h"
+#include "snapshot.h"
+#include "lut.h"
+
+namespace RitoParticle {
+    // Parsed System definitions keyed by the hash of their path relative to
+    // root, loaded once and handed out as shared read-only handles
+    class DefinitionCache {
+    public:
+        using Handle = std::shared_ptr<System const>;
+    private:
+        mutable std::shared_mutex mutex;
+        FlatMap<IniHash, Handle> systems;
+        std::string root;
+
+        // keeps whichever of the two was stored first
+        Handle insert(IniHash h, Handle handle);
+    public:
+        // The one cache of the process, spawn sites should go through this
+        static DefinitionCache& global() noexcept;
+
+        inline static IniHash hash_path(char const* path) noexcept {
+            return IniHash(path);
+        }
+
+        // Parses every troybin under root on threads threads, 0 uses one
+        // per core, already cached paths are skipped. Files are read
+        // ahead in batches through a Prefetcher.
+        // Later get() misses are looked up under this root.
+        // Returns number of files that failed to parse.
+        size_t load_tree(char const* root, size_t threads = 0);
+
+        // Cached definition of path, parsed on first request. Threads
+        // missing on the same path at once may parse it twice, all get the
+        // same handle. Returns nullptr when the file can't be parsed.
+        Handle get(char const* path);
+
+        // Only looks in the cache
+        Handle find(IniHash h) const noexcept;
+
+        size_t size() const noexcept;
+
+        // Writes every cached definition as a Snapshot,
+        // returns -1 when the file can't be opened and -2 on write error
+        int save(char const* filename) const noexcept;
+
+        // Adds definitions from a file written by save(), cached paths keep
+        // their handle. Returns -1 when the file can't be opened, otherwise
+        // the Snapshot::read error - 1.
+        int load_snapshot(char const* filename) noexcept;
+
+        // Curve memory of all cached definitions, with and without sharing
+        // and baked to Luts of max_error
+        Snapshot::CurveReport curve_report(float max_error = lut_max_error) const noexcept;
+
+        // Handles already given out stay valid
+        void clear() noexcept;
+    };
+}
+
+#endif // PARTICLE_CACHE_H
@@ -1,4 +1,5 @@
 #include "fields.h"
+#include "keys.h"
 
 namespace RitoParticle {
 
@@ -6,8 +7,8 @@ bool ini_get(const Ini &ini, IniHash h, FieldAcceleration &val) noexcept {
     if(auto name = ini[h].as<std::string>(); name) {
         IniHash const h = *name;
         val.name = *name;
-        val.isLocalSpace = ini[h * "f-localspace"].as_or<int32_t>() != 0;
-        val.acceleration = ini[h * "f-accel"].as_or<PVec3>(Vec3Inf);
+        val.isLocalSpace = ini[h * Key::f_localspace].as_or<int32_t>() != 0;
+        val.acceleration = ini[h * Key::f_accel].as_or<PVec3>(Vec3Inf);
         return true;
     }
     return false;
@@ -17,9 +18,9 @@ bool ini_get(const Ini &ini, IniHash h, FieldAttraction &val) noexcept {
     if(auto name = ini[h].as<std::string>(); name) {
         IniHash const h = *name;
         val.name = *name;
-        val.position = ini[h * "f-pos"].as_or<PVec3>();
-        val.radius = ini[h * "f-radius"].as_or<PFloat>();
-        val.acceleration = ini[h * "f-accel"].as_or<PFloat>();
+        val.position = ini[h * Key::f_pos].as_or<PVec3>();
+        val.radius = ini[h * Key::f_radius].as_or<PFloat>();
+        val.acceleration = ini[h * Key::f_accel].as_or<PFloat>();
         return true;
     }
     return false;
@@ -29,9 +30,9 @@ bool ini_get(const Ini &ini, IniHash h, FieldDrag &val) noexcept {
     if(auto name = ini[h].as<std::string>(); name) {
         IniHash const h = *name;
         val.name = *name;
-        val.position = ini[h * "f-pos"].as_or<PVec3>();
-        val.radius = ini[h * "f-radius"].as_or<PFloat>();
-        val.strength = ini[h * "f-drag"].as_or<PFloat>();
+        val.position = ini[h * Key::f_pos].as_or<PVec3>();
+        val.radius = ini[h * Key::f_radius].as_or<PFloat>();
+        val.strength = ini[h * Key::f_drag].as_or<PFloat>();
         return true;
     }
     return false;
@@ -41,11 +42,11 @@ bool ini_get(const Ini &ini, IniHash h, FieldNoise &val) noexcept {
     if(auto name = ini[h].as<std::string>(); name) {
         IniHash const h = *name;
         val.name = *name;
-        val.position = ini[h * "f-pos"].as_or<PVec3>();
-        val.radius = ini[h * "f-radius"].as_or<PFloat>();
-        val.period = ini[h * "f-period"].as_or<PFloat>(FLT_MAX);
-        val.velocityDelta = ini[h * "f-veldelta"].as_or<PFloat>();
-        val.axisFraction = ini[h * "f-axisfrac"].as_or<Vec3>(Vec3Inf);
+        val.position = ini[h * Key::f_pos].as_or<PVec3>();
+        val.radius = ini[h * Key::f_radius].as_or<PFloat>();
+        val.period = ini[h * Key::f_period].as_or<PFloat>(FLT_MAX);
+        val.velocityDelta = ini[h * Key::f_veldelta].as_or<PFloat>();
+        val.axisFraction = ini[h * Key::f_axisfrac].as_or<Vec3>(Vec3Inf);
         return true;
     }
     return false;
@@ -55,8 +56,8 @@ bool ini_get(const Ini &ini, IniHash h, FieldOrbital &val) noexcept {
     if(auto name = ini[h].as<std::string>(); name) {
         IniHash const h = *name;
         val.name = *name;
-        val.isLocalSpace = ini[h * "f-localspace"].as_or<int32_t>() != 0;
-        val.direction = ini[h * "f-direction"].as_or<PVec3>(Vec3Inf);
+        val.isLocalSpace = ini[h * Key::f_localspace].as_or<int32_t>() != 0;
+        val.direction = ini[h * Key::f_direction].as_or<PVec3>(Vec3Inf);
         return true;
     }
     return false;
@@ -67,15 +68,15 @@ bool ini_get(const Ini &ini, IniHash h, FluidsDef &val) noexcept {
         IniHash const h = *name;
         val.name = *name;
 
-        val.viscosity = ini[h * "f-viscosity"].as_or<float>();
-        val.diffusion = ini[h * "f-diffusion"].as_or<float>();
-        val.acceleration = ini[h * "f-accel"].as_or<Vec2>();
-        val.buoyancy = ini[h * "f-buoyancy"].as_or<float>();
-        val.dissipation = ini[h * "f-dissipation"].as_or<float>();
-        val.movekick = ini[h * "f-startkick"].as_or<float>(1.0f);
-        val.movedensity = ini[h * "f-denseforce"].as_or<float>();
-        val.movementProjectionX = ini[h * "f-movement-x"].as_or<Vec3>();
-        val.movementProjectionY = ini[h * "f-movement-y"].as_or<Vec3>();
+        val.viscosity = ini[h * Key::f_viscosity].as_or<float>();
+        val.diffusion = ini[h * Key::f_diffusion].as_or<float>();
+        val.acceleration = ini[h * Key::f_accel].as_or<Vec2>();
+        val.buoyancy = ini[h * Key::f_buoyancy].as_or<float>();
+        val.dissipation = ini[h * Key::f_dissipation].as_or<float>();
+        val.movekick = ini[h * Key::f_startkick].as_or<float>(1.0f);
+        val.movedensity = ini[h * Key::f_denseforce].as_or<float>();
+        val.movementProjectionX = ini[h * Key::f_movement_x].as_or<Vec3>();
+        val.movementProjectionY = ini[h * Key::f_movement_y].as_or<Vec3>();
         char const jet_pos[3][10] = {
             "f-jetpos1", "f-jetpos2", "f-jetpos3",
         };
@@ -94,10 +95,10 @@ bool ini_get(const Ini &ini, IniHash h, FluidsDef &val) noexcept {
             val.jetChaos[i] = ini[h * jet_speed[i]].as_or<Vec2>();
             val.jetChaosDir[i] = ini[h * jet_speeddiff[i]].as_or<float>();
         }
-        val.initalDensityMapTex = ini[h * "f-initdensity"].as_or<std::string>("");
-        val.inkFillTime = ini[h * "f-life"].as_or<float>();
-        val.inkFillRate = ini[h * "f-rate"].as_or<float>();
-        val.renderGridSize = ini[h * "f-rendersize"].as_or<int32_t>();
+        val.initalDensityMapTex = ini[h * Key::f_initdensity].as_or<std::string>("");
+        val.inkFillTime = ini[h * Key::f_life].as_or<float>();
+        val.inkFillRate = ini[h * Key::f_rate].as_or<float>();
+        val.renderGridSize = ini[h * Key::f_rendersize].as_or<int32_t>();
         return true;
     }
     return false;
@@ -125,9 +126,9 @@ bool MaterialOverride::load(const Ini &ini, IniHash h, size_t index) noexcept {
 }
 
 bool MaterialOverrideList::load(const Ini &ini, IniHash h) noexcept {
-    transMap = ini[h * "MaterialOverrideTransMap"].as_or<std::string>();
-    transSample = ini[h * "p-trans-sample"].as_or<float>();
-    transSource = ini[h * "MaterialOverrideTransSource"].as_or<int32_t>();
+    transMap = ini[h * Key::MaterialOverrideTransMap].as_or<std::string>();
+    transSample = ini[h * Key::p_trans_sample].as_or<float>();
+    transSource = ini[h * Key::MaterialOverrideTransSource].as_or<int32_t>();
     for(size_t i = 0; i < 4; i++) {
         values[i].load(ini, h, i );
     }
@@ -0,0 +1,180 @@
+#ifndef PARTICLE_KEYS_H
+#define PARTICLE_KEYS_H
+#include <array>
+#include <utility>
+#include "../inibin.h"
+
+namespace RitoParticle {
+    // Field names read by the loaders, name hashes are computed at compile
+    // time so a lookup only combines them with the section hash
+    namespace Key {
+        // emitters and particles
+        inline constexpr IniKey dont_scroll_alpha_UV = "dont-scroll-alpha-UV";
+        inline constexpr IniKey e_active = "e-active";
+        inline constexpr IniKey e_alpharef = "e-alpharef";
+        inline constexpr IniKey e_beam_segments = "e-beam-segments";
+        inline constexpr IniKey e_framerate = "e-framerate";
+        inline constexpr IniKey e_life = "e-life";
+        inline constexpr IniKey e_life_scale = "e-life-scale";
+        inline constexpr IniKey e_linger = "e-linger";
+        inline constexpr IniKey e_local_orient = "e-local-orient";
+        inline constexpr IniKey e_period = "e-period";
+        inline constexpr IniKey e_rate = "e-rate";
+        inline constexpr IniKey e_ratebyvel = "e-ratebyvel";
+        inline constexpr IniKey e_rgba = "e-rgba";
+        inline constexpr IniKey e_tilesize = "e-tilesize";
+        inline constexpr IniKey e_timeoffset = "e-timeoffset";
+        inline constexpr IniKey e_trail_cutoff = "e-trail-cutoff";
+        inline constexpr IniKey e_uvoffset = "e-uvoffset";
+        inline constexpr IniKey e_uvscroll = "e-uvscroll";
+        inline constexpr IniKey Emitter_BirthRotationalAcceleration = "Emitter-BirthRotationalAcceleration";
+        inline constexpr IniKey flag_brighter_in_fow = "flag-brighter-in-fow";
+        inline constexpr IniKey flag_disable_z = "flag-disable-z";
+        inline constexpr IniKey flag_projected = "flag-projected";
+        inline constexpr IniKey fluid_params = "fluid-params";
+        inline constexpr IniKey p_accel = "p-accel";
+        inline constexpr IniKey p_animation = "p-animation";
+        inline constexpr IniKey p_backfaceon = "p-backfaceon";
+        inline constexpr IniKey p_beammode = "p-beammode";
+        inline constexpr IniKey p_bindtoemitter = "p-bindtoemitter";
+        inline constexpr IniKey p_coloroffset = "p-coloroffset";
+        inline constexpr IniKey p_colorscale = "p-colorscale";
+        inline constexpr IniKey p_colortype = "p-colortype";
+        inline constexpr IniKey p_distortion_mode = "p-distortion-mode";
+        inline constexpr IniKey p_distortion_power = "p-distortion-power";
+        inline constexpr IniKey p_drag = "p-drag";
+        inline constexpr IniKey p_falloff_texture = "p-falloff-texture";
+        inline constexpr IniKey p_fixedorbit = "p-fixedorbit";
+        inline constexpr IniKey p_fixedorbittype = "p-fixedorbittype";
+        inline constexpr IniKey p_flexoffset = "p-flexoffset";
+        inline constexpr IniKey p_flexscale = "p-flexscale";
+        inline constexpr IniKey p_framerate = "p-framerate";
+        inline constexpr IniKey p_life = "p-life";
+        inline constexpr IniKey p_life_scale = "p-life-scale";
+        inline constexpr IniKey p_linger = "p-linger";
+        inline constexpr IniKey p_local_orient = "p-local-orient";
+        inline constexpr IniKey p_lockedtoemitter = "p-lockedtoemitter";
+        inline constexpr IniKey p_mesh = "p-mesh";
+        inline constexpr IniKey p_normal_map = "p-normal-map";
+        inline constexpr IniKey p_numframes = "p-numframes";
+        inline constexpr IniKey p_offset = "p-offset";
+        inline constexpr IniKey p_offsetbyheight = "p-offsetbyheight";
+        inline constexpr IniKey p_offsetbyradius = "p-offsetbyradius";
+        inline constexpr IniKey p_orbitvel = "p-orbitvel";
+        inline constexpr IniKey p_orientation = "p-orientation";
+        inline constexpr IniKey p_ostoffset = "p-ostoffset";
+        inline constexpr IniKey p_postoffset = "p-postoffset";
+        inline constexpr IniKey p_projection_fading = "p-projection-fading";
+        inline constexpr IniKey p_projection_y_range = "p-projection-y-range";
+        inline constexpr IniKey p_quadrot = "p-quadrot";
+        inline constexpr IniKey p_randomstartframe = "p-randomstartframe";
+        inline constexpr IniKey p_rgba = "p-rgba";
+        inline constexpr IniKey p_rotvel = "p-rotvel";
+        inline constexpr IniKey p_scale = "p-scale";
+        inline constexpr IniKey p_scalebias = "p-scalebias";
+        inline constexpr IniKey p_scalebyheight = "p-scalebyheight";
+        inline constexpr IniKey p_scalebyradius = "p-scalebyradius";
+        inline constexpr IniKey p_scaleEmitOffset = "p-scaleEmitOffset";
+        inline constexpr IniKey p_scaleupfromorigin = "p-scaleupfromorigin";
+        inline constexpr IniKey p_shadow = "p-shadow";
+        inline constexpr IniKey p_simpleorient = "p-simpleorient";
+        inline constexpr IniKey p_skeleton = "p-skeleton";
+        inline constexpr IniKey p_skin = "p-skin";
+        inline constexpr IniKey p_startframe = "p-startframe";
+        inline constexpr IniKey p_texdiv = "p-texdiv";
+        inline constexpr IniKey p_texture = "p-texture";
+        inline constexpr IniKey p_trailmode = "p-trailmode";
+        inline constexpr IniKey p_type = "p-type";
+        inline constexpr IniKey p_uvmode = "p-uvmode";
+        inline constexpr IniKey p_uvscroll_no_alpha = "p-uvscroll-no-alpha";
+        inline constexpr IniKey p_uvscroll_rgb = "p-uvscroll-rgb";
+        inline constexpr IniKey p_uvscroll_rgb_clamp = "p-uvscroll-rgb-clamp";
+        inline constexpr IniKey p_vecalign = "p-vecalign";
+        inline constexpr IniKey p_vel = "p-vel";
+        inline constexpr IniKey p_worldaccel = "p-worldaccel";
+        inline constexpr IniKey p_xquadrot = "p-xquadrot";
+        inline constexpr IniKey p_xquadrot_on = "p-xquadrot-on";
+        inline constexpr IniKey p_xrgba = "p-xrgba";
+        inline constexpr IniKey p_xscale = "p-xscale";
+        inline constexpr IniKey Particle_Acceleration = "Particle-Acceleration";
+        inline constexpr IniKey Particle_Drag = "Particle-Drag";
+        inline constexpr IniKey Particle_ScaleAlongMovementVector = "Particle-ScaleAlongMovementVector";
+        inline constexpr IniKey Particle_Velocity = "Particle-Velocity";
+        inline constexpr IniKey pass = "pass";
+        inline constexpr IniKey rendermode = "rendermode";
+        inline constexpr IniKey single_particle = "single-particle";
+        inline constexpr IniKey SoundOnCreate = "SoundOnCreate";
+        inline constexpr IniKey SoundPersistent = "SoundPersistent";
+        inline constexpr IniKey teamcolor_correction = "teamcolor-correction";
+        inline constexpr IniKey uniformscale = "uniformscale";
+
+        // fields, fluids and material overrides
+        inline constexpr IniKey f_accel = "f-accel";
+        inline constexpr IniKey f_axisfrac = "f-axisfrac";
+        inline constexpr IniKey f_buoyancy = "f-buoyancy";
+        inline constexpr IniKey f_denseforce = "f-denseforce";
+        inline constexpr IniKey f_diffusion = "f-diffusion";
+        inline constexpr IniKey f_direction = "f-direction";
+        inline constexpr IniKey f_dissipation = "f-dissipation";
+        inline constexpr IniKey f_drag = "f-drag";
+        inline constexpr IniKey f_initdensity = "f-initdensity";
+        inline constexpr IniKey f_life = "f-life";
+        inline constexpr IniKey f_localspace = "f-localspace";
+        inline constexpr IniKey f_movement_x = "f-movement-x";
+        inline constexpr IniKey f_movement_y = "f-movement-y";
+        inline constexpr IniKey f_period = "f-period";
+        inline constexpr IniKey f_pos = "f-pos";
+        inline constexpr IniKey f_radius = "f-radius";
+        inline constexpr IniKey f_rate = "f-rate";
+        inline constexpr IniKey f_rendersize = "f-rendersize";
+        inline constexpr IniKey f_startkick = "f-startkick";
+        inline constexpr IniKey f_veldelta = "f-veldelta";
+        inline constexpr IniKey f_viscosity = "f-viscosity";
+        inline constexpr IniKey MaterialOverrideTransMap = "MaterialOverrideTransMap";
+        inline constexpr IniKey MaterialOverrideTransSource = "MaterialOverrideTransSource";
+        inline constexpr IniKey p_trans_sample = "p-trans-sample";
+
+        // system section
+        inline constexpr IniKey build_up_time = "build-up-time";
+        inline constexpr IniKey group_vis = "group-vis";
+        inline constexpr IniKey KeepOrientationAfterSpellCast = "KeepOrientationAfterSpellCast";
+        inline constexpr IniKey PersistThruDeath = "PersistThruDeath";
+        inline constexpr IniKey SelfIllumination = "SelfIllumination";
+        inline constexpr IniKey SimulateEveryFrame = "SimulateEveryFrame";
+        inline constexpr IniKey SimulateOncePerFrame = "SimulateOncePerFrame";
+        inline constexpr IniKey SimulateWhileOffScreen = "SimulateWhileOffScreen";
+        inline constexpr IniKey SoundEndsOnEmitterEnd = "SoundEndsOnEmitterEnd";
+        inline constexpr IniKey SoundsPlayWhileOffScreen = "SoundsPlayWhileOffScreen";
+
+        // numbered keys of system part i + 1, parts are counted from 1
+        struct GroupPartKeys {
+            IniKey name;
+            IniKey importance;
+            IniKey type;
+            IniKey offset;
+            IniKey rotation;
+            IniKey scale;
+        };
+
+        inline constexpr size_t max_group_parts = 99;
+
+        template<size_t...I>
+        constexpr inline std::array<GroupPartKeys, sizeof...(I)>
+        make_group_parts(std::index_sequence<I...>) noexcept {
+            return {{
+                {
+                    IniKey("GroupPart", static_cast<uint32_t>(I + 1)),
+                    IniKey("GroupPart", static_cast<uint32_t>(I + 1), "Importance"),
+                    IniKey("GroupPart", static_cast<uint32_t>(I + 1), "Type"),
+                    IniKey("Override-Offset", static_cast<uint32_t>(I + 1)),
+                    IniKey("Override-Rotation", static_cast<uint32_t>(I + 1)),
+                    IniKey("Override-Scale", static_cast<uint32_t>(I + 1)),
+                }...
+            }};
+        }
+
+        inline constexpr auto GroupPart = make_group_parts(std::make_index_sequence<max_group_parts>{});
+    }
+}
+
+#endif // PARTICLE_KEYS_H
@@ -0,0 +1,398 @@
+#ifndef PARTICLE_LUT_H
+#define PARTICLE_LUT_H
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <vector>
+#include "ptypes.h"
+
+namespace RitoParticle {
+    // error bake() aims for when none is given, absolute for curves within
+    // [-1, 1] and relative to the largest value past that
+    inline constexpr float lut_max_error = 1.0f / 1024.0f;
+    // resolution stops doubling here, 2^10 segments
+    inline constexpr size_t lut_max_samples = 1025;
+
+    // float to IEEE half, round to nearest even
+    inline uint16_t to_half(float value) noexcept {
+        constexpr uint32_t infinity = 255u << 23;
+        constexpr uint32_t overflow = (127u + 16u) << 23;
+        constexpr uint32_t denorm = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        auto const sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+        bits &= 0x7FFFFFFFu;
+        if(bits >= overflow) {
+            return sign | static_cast<uint16_t>(bits > infinity ? 0x7E00u : 0x7C00u);
+        } else if(bits < (113u << 23)) {
+            float magic;
+            memcpy(&magic, &denorm, sizeof(magic));
+            float rest;
+            memcpy(&rest, &bits, sizeof(rest));
+            rest += magic;
+            memcpy(&bits, &rest, sizeof(bits));
+            return sign | static_cast<uint16_t>(bits - denorm);
+        } else {
+            bits += ((15u - 127u) << 23) + 0xFFFu + ((bits >> 13) & 1u);
+            return sign | static_cast<uint16_t>(bits >> 13);
+        }
+    }
+
+    inline float from_half(uint16_t value) noexcept {
+        constexpr uint32_t exponent = 0x7C00u << 13;
+        uint32_t bits = (value & 0x7FFFu) << 13;
+        auto const e = bits & exponent;
+        bits += (127u - 15u) << 23;
+        float result;
+        if(e == exponent) {
+            bits += (128u - 16u) << 23;
+            memcpy(&result, &bits, sizeof(result));
+        } else if(e == 0) {
+            bits += 1u << 23;
+            memcpy(&result, &bits, sizeof(result));
+            result -= 6.103515625e-05f;
+        } else {
+            memcpy(&result, &bits, sizeof(result));
+        }
+        return (value & 0x8000u) ? -result : result;
+    }
+
+    // One channel of a curve over [0, 1] as evenly spaced 16 bit samples,
+    // linearly interpolated. Times outside are clamped.
+    struct Lut {
+        enum class Format : uint8_t {
+            Constant,
+            // offset + scale * sample
+            Unorm16,
+            Float16,
+        };
+
+        Format format = Format::Constant;
+        // the value of Constant
+        float offset = 0.0f;
+        float scale = 0.0f;
+        // largest difference from the baked curve over [0, 1]
+        float error = 0.0f;
+        std::vector<uint16_t> samples = {};
+
+        inline float decode(uint16_t sample) const noexcept {
+            if(format == Format::Float16) {
+                return from_half(sample);
+            }
+            return offset + scale * static_cast<float>(sample);
+        }
+
+        template<typename D>
+        inline float lerp(D const& decode, float time) const noexcept {
+            auto const last = samples.size() - 1;
+            // also takes NaN to 0
+            auto const x = (time > 0.0f ? (time < 1.0f ? time : 1.0f) : 0.0f)
+                    * static_cast<float>(last);
+            auto const i = std::min(static_cast<size_t>(x), last - 1);
+            auto const a = decode(samples[i]);
+            auto const b = decode(samples[i + 1]);
+            return (b - a) * (x - static_cast<float>(i)) + a;
+        }
+
+        // format is checked once instead of per time
+        template<typename D>
+        inline void lerp_batch(D const& decode, float const* times,
+                               size_t count, float* out) const noexcept {
+            for(size_t i = 0; i < count; i++) {
+                out[i] = lerp(decode, times[i]);
+            }
+        }
+
+        inline float eval(float time) const noexcept {
+            if(samples.size() < 2) {
+                return offset;
+            }
+            return lerp([this](uint16_t sample) { return decode(sample); }, time);
+        }
+
+        inline void eval_batch(float const* times, size_t count, float* out) const noexcept {
+            if(samples.size() < 2) {
+                std::fill_n(out, count, offset);
+            } else if(format == Format::Float16) {
+                lerp_batch([](uint16_t sample) { return from_half(sample); }, times, count, out);
+            } else {
+                lerp_batch([offset = offset, scale = scale](uint16_t sample) {
+                    return offset + scale * static_cast<float>(sample);
+                }, times, count, out);
+            }
+        }
+
+        inline size_t bytes() const noexcept {
+            return sizeof(Lut) + samples.size() * sizeof(uint16_t);
+        }
+    };
+
+    // Fewest segments that put every break inside (0, 1) on a sample
+    inline size_t aligned_segments(std::vector<float> const& breaks) noexcept {
+        for(size_t segments = 1; segments < lut_max_samples; segments++) {
+            auto const aligned = std::all_of(breaks.begin(), breaks.end(), [segments](float time) {
+                auto const x = time * static_cast<float>(segments);
+                return !(time > 0.0f && time < 1.0f) || std::abs(x - std::round(x)) <= 1e-4f;
+            });
+            if(aligned) {
+                return segments;
+            }
+        }
+        return 1;
+    }
+
+    // Bakes curve, a function of time that is linear between breaks.
+    // Tries segment counts from fewest up, powers of two and the aligned
+    // count doubled, until the error is at most max_error scaled like
+    // lut_max_error. Samples are stored in whichever 16 bit format is closer.
+    // Returns -1 when max_error is out of reach, out holds the closest Lut.
+    // Curves that reach NaN or inf return -1 with an infinite error.
+    template<typename F>
+    inline int bake(F const& curve, std::vector<float> const& breaks,
+                    float max_error, Lut& out) noexcept {
+        std::vector<size_t> counts;
+        for(size_t segments = 1; segments < lut_max_samples; segments *= 2) {
+            counts.push_back(segments);
+        }
+        for(size_t segments = aligned_segments(breaks); segments < lut_max_samples; segments *= 2) {
+            counts.push_back(segments);
+        }
+        std::sort(counts.begin(), counts.end());
+        counts.erase(std::unique(counts.begin(), counts.end()), counts.end());
+        // both linear between these, so the error peaks on one of them
+        std::vector<float> checks;
+        std::vector<float> expected;
+        auto measure = [&](Lut& lut) {
+            lut.error = 0.0f;
+            for(size_t i = 0; i < checks.size(); i++) {
+                auto const error = std::abs(lut.eval(checks[i]) - expected[i]);
+                lut.error = error > lut.error || error != error ? error : lut.error;
+            }
+        };
+        std::vector<Lut> tried;
+        for(auto const segments: counts) {
+            auto const size = segments + 1;
+            std::vector<float> values(size);
+            checks.clear();
+            for(size_t i = 0; i < size; i++) {
+                checks.push_back(static_cast<float>(i) / static_cast<float>(segments));
+                values[i] = curve(checks.back());
+            }
+            for(auto const time: breaks) {
+                if(time > 0.0f && time < 1.0f) {
+                    checks.push_back(time);
+                    checks.push_back(std::nextafter(time, 0.0f));
+                }
+            }
+            expected.resize(checks.size());
+            for(size_t i = 0; i < checks.size(); i++) {
+                expected[i] = i < size ? values[i] : curve(checks[i]);
+            }
+            // NaN or inf has no unorm scale and nothing to interpolate,
+            // such curves stay unbaked
+            if(!std::all_of(expected.begin(), expected.end(), [](float value) {
+                return std::isfinite(value);
+            })) {
+                out = Lut{};
+                out.error = std::numeric_limits<float>::infinity();
+                return -1;
+            }
+            auto const [lo, hi] = std::minmax_element(values.begin(), values.end());
+            auto const tolerance = max_error * std::max({ 1.0f, std::abs(*lo), std::abs(*hi) });
+            std::vector<Lut> candidates;
+            if(*lo == *hi) {
+                candidates.push_back({ Lut::Format::Constant, *lo });
+            } else {
+                auto& unorm = candidates.emplace_back(Lut{ Lut::Format::Unorm16, *lo,
+                                                           (*hi - *lo) / 65535.0f });
+                for(auto const value: values) {
+                    auto const sample = std::round((value - *lo) / unorm.scale);
+                    unorm.samples.push_back(static_cast<uint16_t>(std::min(sample, 65535.0f)));
+                }
+                if(std::max(std::abs(*lo), std::abs(*hi)) <= 65504.0f) {
+                    auto& half = candidates.emplace_back(Lut{ Lut::Format::Float16 });
+                    for(auto const value: values) {
+                        half.samples.push_back(to_half(value));
+                    }
+                }
+            }
+            for(auto& lut: candidates) {
+                measure(lut);
+            }
+            auto& closer = *std::min_element(candidates.begin(), candidates.end(),
+                                             [](Lut const& l, Lut const& r) {
+                return l.error < r.error;
+            });
+            if(closer.error <= tolerance) {
+                out = std::move(closer);
+                return 0;
+            }
+            tried.push_back(std::move(closer));
+        }
+        // jumps in the curve stay out of reach at any resolution, past
+        // twice the closest error more samples aren't worth it
+        auto const closest = std::min_element(tried.begin(), tried.end(),
+                                              [](Lut const& l, Lut const& r) {
+            return l.error < r.error;
+        })->error;
+        out = std::move(*std::find_if(tried.begin(), tried.end(), [closest](Lut const& lut) {
+            return !(lut.error > closest * 2.0f);
+        }));
+        return -1;
+    }
+
+    inline int bake(PTable const& table, float max_error, Lut& out) noexcept {
+        std::vector<float> breaks;
+        if(auto const keys = std::get_if<std::vector<TimeValue<float>>>(&table.value)) {
+            for(auto const& key: *keys) {
+                breaks.push_back(key.time);
+            }
+        }
+        return bake([&table](float time) { return table.eval(time); }, breaks, max_error, out);
+    }
+
+    // PVar with every channel and probability table as a Lut, its animation
+    // baked from the keyframes rather than the ramp
+    template<typename T, size_t AXES>
+    struct BakedPVar {
+        std::array<Lut, AXES> anim = {};
+        std::array<std::optional<Lut>, AXES> ptables = {};
+
+        inline T eval_anim(float time) const noexcept {
+            T result = {};
+            for(size_t axis = 0; axis < AXES; axis++) {
+                if constexpr(std::is_same_v<T,float>) {
+                    result = anim[axis].eval(time);
+                } else {
+                    result[axis] = anim[axis].eval(time);
+                }
+            }
+            return result;
+        }
+
+        // draws in the same order as PVar::eval with a Random
+        inline T eval(float time, Random& rng) const noexcept {
+            auto result = eval_anim(time);
+            for(size_t axis = 0; axis < AXES; axis++) {
+                if(auto const& p = ptables[axis]; p) {
+                    if constexpr(std::is_same_v<T,float>) {
+                        result = result * p->eval(rng.uniform());
+                    } else {
+                        result[axis] = result[axis] * p->eval(rng.uniform());
+                    }
+                }
+            }
+            return result;
+        }
+
+        inline void eval_anim_batch(float const* times, size_t count, T* out) const noexcept {
+            if constexpr(std::is_same_v<T,float>) {
+                anim[0].eval_batch(times, count, out);
+            } else {
+                constexpr size_t chunk = 64;
+                float values[chunk];
+                for(size_t beg = 0; beg < count; beg += chunk) {
+                    auto const size = std::min(chunk, count - beg);
+                    for(size_t axis = 0; axis < AXES; axis++) {
+                        anim[axis].eval_batch(times + beg, size, values);
+                        for(size_t i = 0; i < size; i++) {
+                            out[beg + i][axis] = values[i];
+                        }
+                    }
+                }
+            }
+        }
+
+        // draws in the same order as PVar::eval_batch with a Random
+        inline void eval_batch(float const* times, Random& rng, size_t count, T* out) const noexcept {
+            eval_anim_batch(times, count, out);
+            size_t axes[AXES];
+            size_t tables = 0;
+            for(size_t axis = 0; axis < AXES; axis++) {
+                if(ptables[axis]) {
+                    axes[tables++] = axis;
+                }
+            }
+            if(!tables) {
+                return;
+            }
+            constexpr size_t chunk = 64;
+            float drawn[chunk * AXES];
+            float column[chunk];
+            float factors[chunk];
+            for(size_t beg = 0; beg < count; beg += chunk) {
+                auto const size = std::min(chunk, count - beg);
+                rng.uniform(drawn, size * tables);
+                for(size_t t = 0; t < tables; t++) {
+                    auto const axis = axes[t];
+                    for(size_t i = 0; i < size; i++) {
+                        column[i] = drawn[i * tables + t];
+                    }
+                    ptables[axis]->eval_batch(column, size, factors);
+                    for(size_t i = 0; i < size; i++) {
+                        if constexpr(std::is_same_v<T,float>) {
+                            out[beg + i] = out[beg + i] * factors[i];
+                        } else {
+                            out[beg + i][axis] = out[beg + i][axis] * factors[i];
+                        }
+                    }
+                }
+            }
+        }
+
+        // largest error of any animation channel
+        inline float error() const noexcept {
+            float result = 0.0f;
+            for(auto const& lut: anim) {
+                result = std::max(result, lut.error);
+            }
+            return result;
+        }
+
+        inline size_t bytes() const noexcept {
+            size_t result = sizeof(BakedPVar);
+            for(size_t axis = 0; axis < AXES; axis++) {
+                result += anim[axis].bytes() - sizeof(Lut);
+                if(auto const& p = ptables[axis]; p) {
+                    result += p->bytes() - sizeof(Lut);
+                }
+            }
+            return result;
+        }
+    };
+
+    // Returns -1 when any Lut misses max_error, out is still complete
+    template<typename T, size_t AXES>
+    inline int bake(PVar<T, AXES> const& var, float max_error, BakedPVar<T, AXES>& out) noexcept {
+        std::vector<float> breaks;
+        for(auto const& key: var.values) {
+            breaks.push_back(key.time);
+        }
+        int result = 0;
+        for(size_t axis = 0; axis < AXES; axis++) {
+            auto const channel = [&var, axis](float time) -> float {
+                auto const value = EvalTimeValues(var.values, var.base, time);
+                if constexpr(std::is_same_v<T,float>) {
+                    return value;
+                } else {
+                    return value[axis];
+                }
+            };
+            if(bake(channel, breaks, max_error, out.anim[axis]) < 0) {
+                result = -1;
+            }
+            out.ptables[axis].reset();
+            if(auto const& p = var.ptables[axis]; p) {
+                if(bake(*p, max_error, out.ptables[axis].emplace()) < 0) {
+                    result = -1;
+                }
+            }
+        }
+        return result;
+    }
+}
+
+#endif // PARTICLE_LUT_H
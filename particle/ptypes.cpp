@@ -1,5 +1,8 @@
 #include "ptypes.h"
+#include <algorithm>
+#include <cmath>
 #include <cstdio>
+#include <cstring>
 #include <type_traits>
 
 namespace RitoParticle {
@@ -19,6 +22,16 @@ bool ini_get(const Ini &ini, IniHash h, PTable &val) noexcept {
     }
 
     if(tvpairs.size() > 0) {
+        // every key on the same value is that value at any time, classified
+        // here once instead of searching the keys on every eval
+        auto const constant = std::all_of(tvpairs.begin(), tvpairs.end(), [&tvpairs](auto const& key) {
+            return key.value == tvpairs.front().value && std::isfinite(key.value)
+                    && std::isfinite(key.time);
+        });
+        if(constant) {
+            val.value = tvpairs.front().value;
+            return true;
+        }
         if(tvpairs.size() == 2) {
             auto [value0, time0] = tvpairs[0];
             auto [value1, time1] = tvpairs[1];
@@ -36,29 +49,21 @@ bool ini_get(const Ini &ini, IniHash h, PTable &val) noexcept {
 
 bool ini_get(const Ini &ini, IniHash h, PFloat &val) noexcept {
     bool good = false;
-    if(auto const base_str = ini[h].as<std::string>(); base_str) {
-        if(float base_value = {}; sscanf_s(base_str->c_str(), "%f",
-                                           &base_value) == 1) {
-            good = true;
-            val.base = base_value;
-        } else {
-            return false;
-        }
+    float base_value = {};
+    if(auto const n = ini.get_floats(h, &base_value, 1); n == 1) {
+        good = true;
+        val.base = base_value;
+    } else if(n >= 0) {
+        return false;
     }
 
     for(size_t i = 1; i <= 9; i++) {
-        if(auto const r = ini[h + std::to_string(i)].as<std::string>(); r) {
-            float key_time = {};
-            float key_value = {};
-            if(sscanf_s(r->c_str(), "%f %f",
-                        &key_time, &key_value) != 2) {
-                    break;
-            }
-            val.values.push_back({key_time, key_value});
-            good = true;
-        } else {
+        float key[2] = {};
+        if(ini.get_floats(h + std::to_string(i), key, 2) != 2) {
             break;
         }
+        val.values.push_back({key[0], key[1]});
+        good = true;
     }
     val.build_ramp();
 
@@ -74,32 +79,23 @@ bool ini_get(const Ini &ini, IniHash h, PFloat &val) noexcept {
 
 bool ini_get(const Ini &ini, IniHash h, PVec2 &val) noexcept {
     bool good = false;
-    if(auto const base_str = ini[h].as<std::string>(); base_str) {
-        if(Vec2 base_value = {}; sscanf_s(base_str->c_str(), "%f %f",
-                                          &base_value.x,
-                                          &base_value.y) == 2) {
-            good = true;
-            val.base = base_value;
-        } else {
-            return false;
-        }
+    Vec2 base_value = {};
+    if(auto const n = ini.get_floats(h, reinterpret_cast<float*>(&base_value), 2); n == 2) {
+        good = true;
+        val.base = base_value;
+    } else if(n >= 0) {
+        return false;
     }
 
     for(size_t i = 1; i <= 9; i++) {
-        if(auto const r = ini[h + std::to_string(i)].as<std::string>(); r) {
-            float key_time = {};
-            Vec2 key_value = {};
-            if(sscanf_s(r->c_str(), "%f %f %f",
-                        &key_time,
-                        &key_value.x,
-                        &key_value.y) != 3) {
-                    break;
-            }
-            val.values.push_back({key_time, key_value});
-            good = true;
-        } else {
+        float key[3] = {};
+        if(ini.get_floats(h + std::to_string(i), key, 3) != 3) {
             break;
         }
+        Vec2 key_value = {};
+        memcpy(&key_value, key + 1, sizeof(key_value));
+        val.values.push_back({key[0], key_value});
+        good = true;
     }
     val.build_ramp();
 
@@ -117,34 +113,23 @@ bool ini_get(const Ini &ini, IniHash h, PVec2 &val) noexcept {
 
 bool ini_get(const Ini &ini, IniHash h, PVec3 &val) noexcept {
     bool good = false;
-    if(auto const base_str = ini[h].as<std::string>(); base_str) {
-        if(Vec3 base_value = {}; sscanf_s(base_str->c_str(), "%f %f %f",
-                                          &base_value.x,
-                                          &base_value.y,
-                                          &base_value.z) == 3) {
-            good = true;
-            val.base = base_value;
-        } else {
-            return false;
-        }
+    Vec3 base_value = {};
+    if(auto const n = ini.get_floats(h, reinterpret_cast<float*>(&base_value), 3); n == 3) {
+        good = true;
+        val.base = base_value;
+    } else if(n >= 0) {
+        return false;
     }
 
     for(size_t i = 1; i <= 9; i++) {
-        if(auto const r = ini[h + std::to_string(i)].as<std::string>(); r) {
-            float key_time = {};
-            Vec3 key_value = {};
-            if(sscanf_s(r->c_str(), "%f %f %f %f",
-                        &key_time,
-                        &key_value.x,
-                        &key_value.y,
-                        &key_value.z) != 4) {
-                    break;
-            }
-            val.values.push_back({key_time, key_value});
-            good = true;
-        } else {
+        float key[4] = {};
+        if(ini.get_floats(h + std::to_string(i), key, 4) != 4) {
             break;
         }
+        Vec3 key_value = {};
+        memcpy(&key_value, key + 1, sizeof(key_value));
+        val.values.push_back({key[0], key_value});
+        good = true;
     }
     val.build_ramp();
 
@@ -162,36 +147,23 @@ bool ini_get(const Ini &ini, IniHash h, PVec3 &val) noexcept {
 
 bool ini_get(const Ini &ini, IniHash h, PVec4 &val) noexcept {
     bool good = false;
-    if(auto const base_str = ini[h].as<std::string>(); base_str) {
-        if(Vec4 base_value = {}; sscanf_s(base_str->c_str(), "%f %f %f %f",
-                                          &base_value.x,
-                                          &base_value.y,
-                                          &base_value.z,
-                                          &base_value.w) == 4) {
-            good = true;
-            val.base = base_value;
-        } else {
-            return false;
-        }
+    Vec4 base_value = {};
+    if(auto const n = ini.get_floats(h, reinterpret_cast<float*>(&base_value), 4); n == 4) {
+        good = true;
+        val.base = base_value;
+    } else if(n >= 0) {
+        return false;
     }
 
     for(size_t i = 1; i <= 9; i++) {
-        if(auto const r = ini[h + std::to_string(i)].as<std::string>(); r) {
-            float key_time = {};
-            Vec4 key_value = {};
-            if(sscanf_s(r->c_str(), "%f %f %f %f %f",
-                        &key_time,
-                        &key_value.x,
-                        &key_value.y,
-                        &key_value.z,
-                        &key_value.w) != 5) {
-                break;
-            }
-            val.values.push_back({key_time, key_value});
-            good = true;
-        } else {
+        float key[5] = {};
+        if(ini.get_floats(h + std::to_string(i), key, 5) != 5) {
             break;
         }
+        Vec4 key_value = {};
+        memcpy(&key_value, key + 1, sizeof(key_value));
+        val.values.push_back({key[0], key_value});
+        good = true;
     }
     val.build_ramp();
 
@@ -209,36 +181,23 @@ bool ini_get(const Ini &ini, IniHash h, PVec4 &val) noexcept {
 
 bool ini_get(const Ini &ini, IniHash h, PColor &val) noexcept {
     bool good = false;
-    if(auto const base_str = ini[h].as<std::string>(); base_str) {
-        if(ColorF base_value = {}; sscanf_s(base_str->c_str(), "%f %f %f %f",
-                                          &base_value.r,
-                                          &base_value.g,
-                                          &base_value.b,
-                                          &base_value.a) == 1) {
-            good = true;
-            val.base = base_value;
-        } else {
-            return false;
-        }
+    ColorF base_value = {};
+    if(auto const n = ini.get_floats(h, reinterpret_cast<float*>(&base_value), 4); n == 1) {
+        good = true;
+        val.base = base_value;
+    } else if(n >= 0) {
+        return false;
     }
 
     for(size_t i = 1; i <= 9; i++) {
-        if(auto const r = ini[h + std::to_string(i)].as<std::string>(); r) {
-            float key_time = {};
-            ColorF key_value = {};
-            if(sscanf_s(r->c_str(), "%f %f %f %f %f",
-                        &key_time,
-                        &key_value.r,
-                        &key_value.g,
-                        &key_value.b,
-                        &key_value.a) != 5) {
-                break;
-            }
-            val.values.push_back({key_time, key_value});
-            good = true;
-        } else {
+        float key[5] = {};
+        if(ini.get_floats(h + std::to_string(i), key, 5) != 5) {
             break;
         }
+        ColorF key_value = {};
+        memcpy(&key_value, key + 1, sizeof(key_value));
+        val.values.push_back({key[0], key_value});
+        good = true;
     }
     val.build_ramp();
 
@@ -3,6 +3,15 @@
 #include "../types.hpp"
 #include "../inibin.h"
 #include <variant>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include "random.h"
+#include <algorithm>
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE__)
+#include <xmmintrin.h>
+#endif
 
 namespace RitoParticle {
     template<typename T>
@@ -32,6 +41,61 @@ namespace RitoParticle {
         }
     }
 
+    // EvalTimeValues for count times against the same curve. Keyframes are
+    // turned into segments once and 4 times are interpolated per step, results
+    // match EvalTimeValues bit for bit, TroyCurveCheck compares the two. Keys
+    // that are not in ascending order take the scalar path, the first key past
+    // time is not the segment end there.
+    inline void EvalTimeValuesBatch(std::vector<TimeValue<float>> const& value, float base,
+                                    float const* times, size_t count, float* out) noexcept {
+        if(value.empty()) {
+            std::fill_n(out, count, base);
+            return;
+        }
+        bool sorted = true;
+        for(size_t k = 1; k < value.size(); k++) {
+            sorted = sorted && value[k - 1].time <= value[k].time;
+        }
+        size_t i = 0;
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE__)
+        if(sorted) {
+            auto const keys = value.size();
+            auto const one = _mm_set1_ps(1.0f);
+            auto const front = _mm_set1_ps(value.front().value);
+            auto const back = _mm_set1_ps(value.back().value);
+            auto const scale = _mm_set1_ps(base);
+            auto const select = [](__m128 mask, __m128 l, __m128 r) {
+                return _mm_or_ps(_mm_and_ps(mask, l), _mm_andnot_ps(mask, r));
+            };
+            for(; i + 4 <= count; i += 4) {
+                auto const time = _mm_loadu_ps(times + i);
+                // segment index, keys not past time, same as find_if on sorted keys
+                auto segment = _mm_setzero_ps();
+                for(size_t k = 0; k < keys; k++) {
+                    auto const not_past = _mm_cmpngt_ps(_mm_set1_ps(value[k].time), time);
+                    segment = _mm_add_ps(segment, _mm_and_ps(not_past, one));
+                }
+                auto result = select(_mm_cmpeq_ps(segment, _mm_setzero_ps()), front, back);
+                for(size_t k = 1; k < keys; k++) {
+                    auto const first_time = _mm_set1_ps(value[k - 1].time);
+                    auto const first_value = _mm_set1_ps(value[k - 1].value);
+                    auto const delta_time = _mm_set1_ps(value[k].time - value[k - 1].time);
+                    auto const delta_value = _mm_set1_ps(value[k].value - value[k - 1].value);
+                    auto const factor = _mm_div_ps(_mm_sub_ps(time, first_time), delta_time);
+                    auto const lerp = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(delta_value, factor),
+                                                            first_value), scale);
+                    result = select(_mm_cmpeq_ps(segment, _mm_set1_ps(static_cast<float>(k))),
+                                    lerp, result);
+                }
+                _mm_storeu_ps(out + i, result);
+            }
+        }
+#endif
+        for(; i < count; i++) {
+            out[i] = EvalTimeValues(value, base, times[i]);
+        }
+    }
+
     struct FlatLine {
         float base;
         float delta;
@@ -39,8 +103,9 @@ namespace RitoParticle {
 
     struct PTable {
         std::variant<float, FlatLine, std::vector<TimeValue<float>>> value = { 1.0f };
+        // draws from the thread's Random::local() stream without randomv
         float eval(std::optional<float> randomv) const {
-            float time = randomv.value_or(rand() / static_cast<float>(RAND_MAX));
+            float time = randomv ? *randomv : Random::local().uniform();
             return std::visit([time](auto&& value) -> float {
                 using T = std::decay_t<decltype(value)>;
                 if constexpr(std::is_same_v<T, float>) {
@@ -52,27 +117,137 @@ namespace RitoParticle {
                 }
             }, value);
         }
+
+        inline float eval(Random& rng) const {
+            return eval(rng.uniform());
+        }
+
+        // eval for count random values at once
+        inline void eval_batch(float const* randoms, size_t count, float* out) const noexcept {
+            std::visit([randoms, count, out](auto&& value) {
+                using T = std::decay_t<decltype(value)>;
+                if constexpr(std::is_same_v<T, float>) {
+                    std::fill_n(out, count, value);
+                } else if constexpr(std::is_same_v<T, FlatLine>) {
+                    for(size_t i = 0; i < count; i++) {
+                        out[i] = value.delta * randoms[i] + value.base;
+                    }
+                } else {
+                    EvalTimeValuesBatch(value, 1.0f, randoms, count, out);
+                }
+            }, value);
+        }
     };
 
     extern bool ini_get(Ini const& ini, IniHash h, PTable& val) noexcept;
 
+    template<typename T>
+    using Ramp = std::array<T, 256>;
+
+    // Ramps of every loaded PVar, equal ramps are stored once and freed
+    // when the last PVar using them goes away
+    template<typename T>
+    class CurvePool {
+    private:
+        struct Entry {
+            Ramp<T> const* ptr;
+            std::weak_ptr<Ramp<T> const> weak;
+        };
+
+        std::mutex mutex;
+        // by content hash, collisions that differ get their own entry
+        std::unordered_map<uint64_t, std::vector<Entry>> ramps;
+
+        inline static uint64_t content_hash(Ramp<T> const& ramp) noexcept {
+            auto const bytes = reinterpret_cast<uint8_t const*>(ramp.data());
+            uint64_t result = 0xCBF29CE484222325ull;
+            for(size_t i = 0; i < sizeof(ramp); i++) {
+                result = (result ^ bytes[i]) * 0x100000001B3ull;
+            }
+            return result;
+        }
+
+        // deleter of interned ramps, drops their entry and an emptied bucket
+        inline void release(uint64_t h, Ramp<T> const* ptr) noexcept {
+            {
+                std::lock_guard lock(mutex);
+                if(auto const b = ramps.find(h); b != ramps.end()) {
+                    auto& bucket = b->second;
+                    auto const e = std::find_if(bucket.begin(), bucket.end(), [ptr](Entry const& e) {
+                        return e.ptr == ptr;
+                    });
+                    if(e != bucket.end()) {
+                        *e = std::move(bucket.back());
+                        bucket.pop_back();
+                    }
+                    if(bucket.empty()) {
+                        ramps.erase(b);
+                    }
+                }
+            }
+            delete ptr;
+        }
+    public:
+        // never destroyed, PVars in statics may release ramps after it would be
+        inline static CurvePool& global() noexcept {
+            static CurvePool* pool = new CurvePool();
+            return *pool;
+        }
+
+        inline std::shared_ptr<Ramp<T> const> intern(Ramp<T> const& ramp) {
+            auto const h = content_hash(ramp);
+            // released after unlocking, dropping the last reference runs release()
+            std::vector<std::shared_ptr<Ramp<T> const>> checked;
+            std::lock_guard lock(mutex);
+            auto& bucket = ramps[h];
+            for(auto const& entry: bucket) {
+                // expired ones are about to be removed by their release()
+                if(auto shared = entry.weak.lock(); !shared) {
+                    continue;
+                } else if(memcmp(shared->data(), ramp.data(), sizeof(ramp)) == 0) {
+                    return shared;
+                } else {
+                    checked.push_back(std::move(shared));
+                }
+            }
+            std::shared_ptr<Ramp<T> const> result(new Ramp<T>(ramp), [this, h](Ramp<T> const* ptr) {
+                release(h, ptr);
+            });
+            bucket.push_back(Entry { result.get(), result });
+            return result;
+        }
+
+        // Ramps still in use
+        inline size_t size() noexcept {
+            std::lock_guard lock(mutex);
+            size_t result = 0;
+            for(auto const& [h, bucket]: ramps) {
+                result += bucket.size();
+            }
+            return result;
+        }
+    };
+
     template<typename T, size_t AXES>
     struct PVar {
         T base = {};
-        std::array<T, 256> ramp = {};
+        // shared from CurvePool, only set when there are keyframes
+        std::shared_ptr<Ramp<T> const> ramp = {};
         std::vector<TimeValue<T>> values = {};
         std::array<std::optional<PTable>, AXES> ptables = {};
 
         inline void build_ramp() noexcept {
             if constexpr(!std::is_same_v<T,float>) {
-                if(values.size()) {
-                    int i = 0;
-                    for(auto& r: ramp) {
-                        float const time_factor = 1.0f / static_cast<float>(ramp.size());
-                        r = EvalTimeValues(values, base, i * time_factor);
-                        ++i;
-                    }
+                if(values.empty()) {
+                    ramp.reset();
+                    return;
+                }
+                Ramp<T> result;
+                float const time_factor = 1.0f / static_cast<float>(result.size());
+                for(size_t i = 0; i < result.size(); i++) {
+                    result[i] = EvalTimeValues(values, base, i * time_factor);
                 }
+                ramp = CurvePool<T>::global().intern(result);
             }
         }
 
@@ -92,14 +267,32 @@ namespace RitoParticle {
             return value;
         }
 
+        // every table draws its own value from rng
+        inline T apply_probability(T value, Random& rng) const noexcept {
+            for(size_t i = 0; i < AXES; i++) {
+                if(auto const& p = ptables[i]; p) {
+                    if constexpr(std::is_same_v<T,float>) {
+                        value = value * p->eval(rng);
+                    } else {
+                        value[i] = value[i] * p->eval(rng);
+                    }
+                }
+            }
+            return value;
+        }
+
         inline T eval_anim(float time) const noexcept {
             if(values.empty()) {
                 return base;
             } else {
                 if constexpr(std::is_same_v<T,float>) {
                     return EvalTimeValues(values, base, time);
+                } else if(!ramp) {
+                    // build_ramp() not called
+                    return EvalTimeValues(values, base, time);
                 } else {
-                    return ramp[static_cast<uint8_t>(time * static_cast<float>(ramp.size()))];
+                    auto const& r = *ramp;
+                    return r[static_cast<uint8_t>(time * static_cast<float>(r.size()))];
                 }
             }
         }
@@ -107,6 +300,85 @@ namespace RitoParticle {
         inline T eval(float time, std::optional<float> randv = std::nullopt) const noexcept {
             return apply_probability(eval_anim(time), randv);
         }
+
+        inline T eval(float time, Random& rng) const noexcept {
+            return apply_probability(eval_anim(time), rng);
+        }
+
+        // eval_anim for count times, e.g. the lifetime fraction of every particle
+        inline void eval_anim_batch(float const* times, size_t count, T* out) const noexcept {
+            if(values.empty()) {
+                std::fill_n(out, count, base);
+            } else if constexpr(std::is_same_v<T,float>) {
+                EvalTimeValuesBatch(values, base, times, count, out);
+            } else if(!ramp) {
+                for(size_t i = 0; i < count; i++) {
+                    out[i] = EvalTimeValues(values, base, times[i]);
+                }
+            } else {
+                auto const& r = *ramp;
+                for(size_t i = 0; i < count; i++) {
+                    out[i] = r[static_cast<uint8_t>(times[i] * static_cast<float>(r.size()))];
+                }
+            }
+        }
+
+        // eval for count times, randoms[i] is the randv of times[i], each
+        // table draws its own from Random::local() when randoms is nullptr
+        inline void eval_batch(float const* times, float const* randoms,
+                               size_t count, T* out) const noexcept {
+            eval_batch(times, randoms, Random::local(), count, out);
+        }
+
+        // Same with every table drawing count values from rng
+        inline void eval_batch(float const* times, Random& rng,
+                               size_t count, T* out) const noexcept {
+            eval_batch(times, nullptr, rng, count, out);
+        }
+
+        // randoms when given, otherwise the tables draw from rng in the same
+        // order as eval(time, rng) on each time, particle by particle
+        inline void eval_batch(float const* times, float const* randoms, Random& rng,
+                               size_t count, T* out) const noexcept {
+            eval_anim_batch(times, count, out);
+            size_t axes[AXES];
+            size_t tables = 0;
+            for(size_t axis = 0; axis < AXES; axis++) {
+                if(ptables[axis]) {
+                    axes[tables++] = axis;
+                }
+            }
+            if(!tables) {
+                return;
+            }
+            constexpr size_t chunk = 64;
+            float drawn[chunk * AXES];
+            float column[chunk];
+            float factors[chunk];
+            for(size_t beg = 0; beg < count; beg += chunk) {
+                auto const size = std::min(chunk, count - beg);
+                if(!randoms) {
+                    rng.uniform(drawn, size * tables);
+                }
+                for(size_t t = 0; t < tables; t++) {
+                    auto const axis = axes[t];
+                    auto source = randoms ? randoms + beg : column;
+                    if(!randoms) {
+                        for(size_t i = 0; i < size; i++) {
+                            column[i] = drawn[i * tables + t];
+                        }
+                    }
+                    ptables[axis]->eval_batch(source, size, factors);
+                    for(size_t i = 0; i < size; i++) {
+                        if constexpr(std::is_same_v<T,float>) {
+                            out[beg + i] = out[beg + i] * factors[i];
+                        } else {
+                            out[beg + i][axis] = out[beg + i][axis] * factors[i];
+                        }
+                    }
+                }
+            }
+        }
     };
 
     using PFloat = PVar<float, 1>;
@@ -0,0 +1,113 @@
+#ifndef PARTICLE_RANDOM_H
+#define PARTICLE_RANDOM_H
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+namespace RitoParticle {
+    // xoshiro128+ stream, same seed gives the same sequence on every
+    // platform. Not shared between threads, give each its own stream.
+    struct Random {
+        // seeds of threads that never called set_local() count up from here
+        inline constexpr static uint64_t local_seed = 0x6C6F63616C000000ull;
+
+        uint32_t s[4];
+
+        inline static uint64_t splitmix(uint64_t& x) noexcept {
+            uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+
+        inline static uint32_t rotl(uint32_t x, int k) noexcept {
+            return (x << k) | (x >> (32 - k));
+        }
+
+        inline explicit Random(uint64_t seed = 0) noexcept {
+            reseed(seed);
+        }
+
+        inline void reseed(uint64_t seed) noexcept {
+            auto const a = splitmix(seed);
+            auto const b = splitmix(seed);
+            s[0] = static_cast<uint32_t>(a);
+            s[1] = static_cast<uint32_t>(a >> 32);
+            s[2] = static_cast<uint32_t>(b);
+            s[3] = static_cast<uint32_t>(b >> 32);
+            if(!(s[0] | s[1] | s[2] | s[3])) {
+                s[0] = 1;
+            }
+        }
+
+        inline uint32_t next() noexcept {
+            auto const result = s[0] + s[3];
+            auto const t = s[1] << 9;
+            s[2] ^= s[0];
+            s[3] ^= s[1];
+            s[1] ^= s[2];
+            s[0] ^= s[3];
+            s[2] ^= t;
+            s[3] = rotl(s[3], 11);
+            return result;
+        }
+
+        // in [0, 1), low bits of xoshiro128+ are weak so only the top 24 are used
+        inline float uniform() noexcept {
+            return static_cast<float>(next() >> 8) * (1.0f / 16777216.0f);
+        }
+
+        inline void uniform(float* out, size_t count) noexcept {
+            for(size_t i = 0; i < count; i++) {
+                out[i] = uniform();
+            }
+        }
+
+        // Advances by 2^64 draws, streams split off this way never overlap
+        inline void jump() noexcept {
+            constexpr uint32_t table[4] = { 0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b };
+            uint32_t result[4] = {};
+            for(auto const word: table) {
+                for(int b = 0; b < 32; b++) {
+                    if(word & (1u << b)) {
+                        for(size_t i = 0; i < 4; i++) {
+                            result[i] ^= s[i];
+                        }
+                    }
+                    next();
+                }
+            }
+            for(size_t i = 0; i < 4; i++) {
+                s[i] = result[i];
+            }
+        }
+
+        // Stream index of seed, for one stream per thread or per emitter
+        inline static Random stream(uint64_t seed, size_t index) noexcept {
+            Random result(seed);
+            for(size_t i = 0; i < index; i++) {
+                result.jump();
+            }
+            return result;
+        }
+
+        // Stream of the calling thread, used when no stream is passed in.
+        // A thread that never called set_local() is seeded from a counter in
+        // the order threads first ask, so workers don't repeat each other's
+        // draws but a run only replays the same once every thread drawing
+        // from local() called set_local().
+        inline static Random& local() noexcept {
+            static std::atomic<uint64_t> threads = 0;
+            thread_local Random rng(local_seed + threads.fetch_add(1, std::memory_order_relaxed));
+            return rng;
+        }
+
+        // Restarts the calling thread's local() at stream index of seed,
+        // give every worker its own index so their draws don't repeat
+        inline static void set_local(size_t index, uint64_t seed = 0) noexcept {
+            local() = stream(seed, index);
+        }
+    };
+}
+
+#endif // PARTICLE_RANDOM_H
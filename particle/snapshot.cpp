@@ -0,0 +1,415 @@
+#include "snapshot.h"
+#include "lut.h"
+#include <cstring>
+#include <type_traits>
+#include <unordered_set>
+#include "../file.hpp"
+
+namespace RitoParticle {
+
+namespace {
+struct Writer {
+    inline constexpr static bool reading = false;
+
+    std::vector<uint8_t>& out;
+
+    template<typename T>
+    inline bool raw(T const* data, size_t count) noexcept {
+        auto const src = reinterpret_cast<uint8_t const*>(data);
+        out.insert(out.end(), src, src + count * sizeof(T));
+        return true;
+    }
+
+    inline size_t left() const noexcept { return SIZE_MAX; }
+
+    template<typename T, size_t AXES>
+    inline void curve(PVar<T, AXES> const&) noexcept {}
+};
+
+struct Reader {
+    inline constexpr static bool reading = true;
+
+    MemoryFile const& file;
+
+    template<typename T>
+    inline bool raw(T* data, size_t count) noexcept {
+        return file.read(data, count);
+    }
+
+    inline size_t left() const noexcept { return file.end - file.pos; }
+
+    template<typename T, size_t AXES>
+    inline void curve(PVar<T, AXES> const&) noexcept {}
+};
+
+// Walks like Writer without writing, adds up what the curves take
+struct Measure {
+    inline constexpr static bool reading = false;
+
+    float max_error;
+    Snapshot::CurveReport report;
+    std::unordered_set<void const*> seen;
+
+    template<typename T>
+    inline bool raw(T const*, size_t) noexcept { return true; }
+
+    inline size_t left() const noexcept { return SIZE_MAX; }
+
+    template<typename T, size_t AXES>
+    inline void curve(PVar<T, AXES> const& v) noexcept {
+        auto const& ramp = v.ramp;
+        report.pvars++;
+        report.inline_bytes += sizeof(Ramp<T>);
+        report.pooled_bytes += sizeof(ramp);
+        if(!v.values.empty()) {
+            BakedPVar<T, AXES> baked;
+            if(bake(v, max_error, baked) < 0) {
+                report.missed++;
+            }
+            report.baked_bytes += baked.bytes();
+        }
+        if(!ramp) {
+            return;
+        }
+        report.curves++;
+        if(seen.insert(ramp.get()).second) {
+            report.unique++;
+            report.pooled_bytes += sizeof(Ramp<T>);
+        }
+    }
+};
+
+template<typename T>
+struct is_optional : std::false_type {};
+
+template<typename T>
+struct is_optional<std::optional<T>> : std::true_type {};
+
+template<typename T>
+struct is_variant : std::false_type {};
+
+template<typename...T>
+struct is_variant<std::variant<T...>> : std::true_type {};
+
+// copied as bytes, optional and variant are trivially copyable for some
+// types but their layout is up to the library
+template<typename T>
+inline constexpr bool is_plain = std::is_trivially_copyable_v<T>
+        && !is_optional<T>::value && !is_variant<T>::value;
+
+// fewest bytes one T takes in the stream, bounds counts before anything
+// is allocated for them
+template<typename T>
+struct min_size : std::integral_constant<size_t, is_plain<T> ? sizeof(T) : 1> {};
+
+template<>
+struct min_size<std::string> : std::integral_constant<size_t, sizeof(uint32_t)> {};
+
+template<typename T>
+struct min_size<std::vector<T>> : std::integral_constant<size_t, sizeof(uint32_t)> {};
+
+template<typename A, typename T>
+inline std::enable_if_t<is_plain<T>, bool> transfer(A& a, T& v) noexcept {
+    return a.raw(&v, 1);
+}
+
+template<typename A, typename...T>
+inline bool fields(A& a, T&...v) noexcept {
+    return (transfer(a, v) && ...);
+}
+
+template<typename A>
+inline bool transfer(A& a, std::string& v) noexcept {
+    auto size = static_cast<uint32_t>(v.size());
+    if(!transfer(a, size) || size > a.left()) {
+        return false;
+    }
+    if constexpr(A::reading) {
+        v.resize(size);
+    }
+    return a.raw(v.data(), size);
+}
+
+template<typename A, typename T>
+inline bool transfer(A& a, std::vector<T>& v) noexcept {
+    auto size = static_cast<uint32_t>(v.size());
+    if(!transfer(a, size) || size > a.left() / min_size<T>::value) {
+        return false;
+    }
+    if constexpr(A::reading) {
+        v.resize(size);
+    }
+    if constexpr(is_plain<T>) {
+        return a.raw(v.data(), size);
+    } else {
+        for(auto& item: v) {
+            if(!transfer(a, item)) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+template<typename A, typename T, size_t N>
+inline std::enable_if_t<!is_plain<std::array<T, N>>, bool>
+transfer(A& a, std::array<T, N>& v) noexcept {
+    for(auto& item: v) {
+        if(!transfer(a, item)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename A, typename T>
+inline bool transfer(A& a, std::optional<T>& v) noexcept {
+    auto has = static_cast<uint8_t>(v.has_value());
+    if(!transfer(a, has)) {
+        return false;
+    }
+    if constexpr(A::reading) {
+        if(!has) {
+            v.reset();
+            return true;
+        }
+        v.emplace();
+    } else if(!has) {
+        return true;
+    }
+    return transfer(a, *v);
+}
+
+template<size_t I, typename V>
+inline void emplace_index(V& v, size_t index) noexcept {
+    if constexpr(I < std::variant_size_v<V>) {
+        if(index == I) {
+            v.template emplace<I>();
+        } else {
+            emplace_index<I + 1>(v, index);
+        }
+    }
+}
+
+template<typename A, typename...T>
+inline bool transfer(A& a, std::variant<T...>& v) noexcept {
+    auto index = static_cast<uint8_t>(v.index());
+    if(!transfer(a, index) || index >= sizeof...(T)) {
+        return false;
+    }
+    if constexpr(A::reading) {
+        emplace_index<0>(v, index);
+    }
+    return std::visit([&a](auto& value) { return transfer(a, value); }, v);
+}
+
+template<typename A>
+inline bool transfer(A& a, PTable& v) noexcept {
+    return transfer(a, v.value);
+}
+
+template<typename A, typename T, size_t AXES>
+inline bool transfer(A& a, PVar<T, AXES>& v) noexcept {
+    if(!fields(a, v.base, v.values, v.ptables)) {
+        return false;
+    }
+    a.curve(v);
+    if constexpr(A::reading) {
+        v.build_ramp();
+    }
+    return true;
+}
+
+template<typename A, typename T>
+inline bool transfer(A& a, Flex<T>& v) noexcept {
+    auto idx = static_cast<uint64_t>(v.idx);
+    if(!fields(a, v.value, idx)) {
+        return false;
+    }
+    v.idx = static_cast<size_t>(idx);
+    return true;
+}
+
+template<typename A>
+inline bool transfer(A& a, FieldAcceleration& v) noexcept {
+    return fields(a, v.name, v.isLocalSpace, v.acceleration);
+}
+
+template<typename A>
+inline bool transfer(A& a, FieldAttraction& v) noexcept {
+    return fields(a, v.name, v.position, v.radius, v.acceleration);
+}
+
+template<typename A>
+inline bool transfer(A& a, FieldDrag& v) noexcept {
+    return fields(a, v.name, v.position, v.radius, v.strength);
+}
+
+template<typename A>
+inline bool transfer(A& a, FieldNoise& v) noexcept {
+    return fields(a, v.name, v.position, v.radius, v.period, v.velocityDelta, v.axisFraction);
+}
+
+template<typename A>
+inline bool transfer(A& a, FieldOrbital& v) noexcept {
+    return fields(a, v.name, v.isLocalSpace, v.direction);
+}
+
+template<typename A>
+inline bool transfer(A& a, FluidsDef& v) noexcept {
+    return fields(a, v.name, v.viscosity, v.diffusion, v.acceleration, v.buoyancy,
+                  v.dissipation, v.movekick, v.movedensity, v.movementProjectionX,
+                  v.movementProjectionY, v.jetKinetics, v.jetKineticsDir, v.jetChaos,
+                  v.jetChaosDir, v.initalDensityMapTex, v.inkFillTime, v.inkFillRate,
+                  v.renderGridSize);
+}
+
+template<typename A>
+inline bool transfer(A& a, MaterialOverride& v) noexcept {
+    return fields(a, v.subMeshName, v.texture, v.priority, v.renderingMode);
+}
+
+template<typename A>
+inline bool transfer(A& a, MaterialOverrideList& v) noexcept {
+    return fields(a, v.values, v.transMap, v.transSample, v.transSource);
+}
+
+template<typename A>
+inline bool transfer(A& a, SimpleEmitter& v) noexcept {
+    return fields(a, v.name, v.rate, v.particleLifetime, v.doesParticleLifetimeScales,
+                  v.particleLinger, v.emitterLinger, v.birthTranslation, v.birthRotation,
+                  v.birthScale, v.birthVelocity, v.birthRotationalVelocity, v.emitOffset,
+                  v.emitRotationAngles, v.emitRotationAxes, v.isLocalOrientation,
+                  v.particleIsLocalOrientation, v.hasFixedOrbit, v.fixedOrbitType,
+                  v.particleBind, v.lockedToEmitter, v.timeBeforeFirstEmission, v.lifetime,
+                  v.doesLifetimeScale, v.period, v.timeActiveDuringPeriod, v.doesCastShadow,
+                  v.isSingleParticle, v.startFrame, v.numFrames, v.frameRate, v.quadType,
+                  v.uvScrollRate, v.uvScrollClamp, v.isDirectionOriented,
+                  v.scaleAlongMovementVector, v.scale, v.rotation, v.rotationIsEnabled,
+                  v.projectionYRange, v.projectionFading, v.scaleBias, v.orientation,
+                  v.isRandomStartFrame, v.scaleUpFromOrigin, v.colorLookUpTypes,
+                  v.colorLookUpScales, v.colorLookUpOffsets,
+                  v.scaleEmitOffsetByBoundObjectSize, v.scaleBirthScaleByBoundObjectSize,
+                  v.scaleEmitOffsetByBoundObjectHeight, v.scaleBirthScaleByBoundObjectHeight,
+                  v.scaleEmitOffsetByBoundObjectRadius, v.scaleBirthScaleByBoundObjectRadius,
+                  v.meshFileName, v.meshSkinMeshFileName, v.meshSkeleton, v.meshAnimation,
+                  v.meshDisableBackfaceCull, v.attachmentTypeString, v.ExcludeAttachmentTypes,
+                  v.keywordsExcluded, v.keywordsRequired, v.fieldAccelerationList,
+                  v.fieldAttractionList, v.fieldDragList, v.fieldNoiseList,
+                  v.fieldOrbitalList, v.fluid, v.materialOverrides, v.soundOnCreate,
+                  v.soundPersistentName, v.flexScaleEmitOffset, v.flexScaleBirthScale,
+                  v.flexOffset, v.flexBirthTranslation, v.flexRate,
+                  v.flexBirthRotationVelocity, v.flexParticleLifetime, v.flexBirthVelocity);
+}
+
+template<typename A>
+inline bool transfer(A& a, SimpleParticle& v) noexcept {
+    return fields(a, v.name, v.blendMode, v.renderFlags, v.pass, v.alpharef, v.texture,
+                  v.colorTex, v.normalMapTex, v.falloffTex, v.distortion, v.distortionMode,
+                  v.texDiv, v.emitters, v.uvmode);
+}
+
+template<typename A>
+inline bool transfer(A& a, ComplexParticle& v) noexcept {
+    return fields(a, v.name, v.startFrame, v.numFrames, v.frameRate, v.quadType,
+                  v.meshFileName, v.meshSkinMeshFileName, v.meshSkeleton, v.meshAnimation,
+                  v.uvScrollRate, v.isDirectionOriented, v.scaleAlongMovementVector,
+                  v.isUniformScale, v.hasPostRotateOrientation, v.postRotateOrientation,
+                  v.isLocalOrientation, v.isRandomStartFrame, v.doesCastShadow, v.distortion,
+                  v.uvMode, v.trailMode, v.beamMode, v.projectionYRange, v.projectionFading,
+                  v.velocity, v.acceleration, v.worldAcceleration, v.scale, v.color,
+                  v.bindWeight, v.drag, v.rotation, v.rotationIsEnabled);
+}
+
+template<typename A>
+inline bool transfer(A& a, ComplexEmitter& v) noexcept {
+    return fields(a, v.name, v.particle, v.blendMode, v.renderFlags, v.pass, v.alphaRef,
+                  v.meshDisableBackfaceCull, v.texture, v.particleColorTex, v.fallofTex,
+                  v.normalMapTex, v.texDiv, v.rate, v.particleLifetime,
+                  v.doesParticleLifetimeScale, v.distortion, v.distortionMode,
+                  v.birthTranslation, v.birthRotation, v.birthScale, v.birthColor,
+                  v.birthVelocity, v.birthAcceleration, v.birthRotationalVelocity,
+                  v.birthRotationalAcceleration, v.birthDrag, v.birthOrbitalVelocity,
+                  v.birthFrameRate, v.birthTilingSize, v.birthUVOffset,
+                  v.rateByVelocityFunction, v.uvScroll, v.emitOffset, v.emitRotationAngles,
+                  v.emitRotationAxes, v.isLocalOrientation, v.timeBeforeFirstEmission,
+                  v.lifetime, v.doesLifetimeScale, v.period, v.timeActiveDuringPeriod,
+                  v.trailCutoff, v.beamSegments, v.isSingleParticle, v.particleLinger,
+                  v.emitterLinger, v.colorLookupTypes, v.colorLookUpScales,
+                  v.colorLookUpOffsets, v.scaleEmitOffsetByBoundObjectSize,
+                  v.scaleBirthScaleByBoundObjectSize, v.scaleEmitOffsetByBoundObjectHeight,
+                  v.scaleBirthScaleByBoundObjectHeight, v.scaleEmitOffsetByBoundObjectRadius,
+                  v.scaleBirthScaleByBoundObjectRadius, v.attachmentType,
+                  v.excludeAttachmentTypes, v.keywordsExcluded, v.keywordsRequired,
+                  v.materialOverrides, v.soundOnCreateName, v.soundPersistentName,
+                  v.flexScaleEmitOffset, v.flexScaleBirthScale, v.flexOffset,
+                  v.flexBirthUVOffset, v.flexBirthTranslation, v.flexRate,
+                  v.flexBirthRotationalVelocity, v.flexParticleLifetime, v.fluid);
+}
+
+template<typename A>
+inline bool transfer(A& a, Part& v) noexcept {
+    return fields(a, v.definition, v.importance, v.translation, v.rotation, v.scale);
+}
+
+template<typename A>
+inline bool transfer(A& a, System& v) noexcept {
+    return fields(a, v.parts, v.visibilityRadius, v.soundOnCreateDefault,
+                  v.soundPersistentDefault, v.flags, v.buildUpTime,
+                  v.materialOverrideList, v.selfIllumination, v.importance);
+}
+
+inline constexpr char magic[4] = { 'T', 'P', 'S', 'S' };
+}
+
+void Snapshot::write(std::vector<uint8_t>& out, Entry const* entries, size_t count) noexcept {
+    Writer writer = { out };
+    Header const header = { { magic[0], magic[1], magic[2], magic[3] },
+                            version, static_cast<uint32_t>(count) };
+    writer.raw(&header, 1);
+    for(size_t i = 0; i < count; i++) {
+        auto hash = static_cast<uint32_t>(entries[i].first);
+        writer.raw(&hash, 1);
+        // the writer only reads through the reference
+        transfer(writer, const_cast<System&>(*entries[i].second));
+    }
+}
+
+Snapshot::CurveReport Snapshot::measure_curves(Entry const* entries, size_t count,
+                                               float max_error) noexcept {
+    Measure measure = { max_error, {}, {} };
+    for(size_t i = 0; i < count; i++) {
+        transfer(measure, const_cast<System&>(*entries[i].second));
+    }
+    return measure.report;
+}
+
+int Snapshot::read(uint8_t const* data, size_t size,
+                   std::vector<std::pair<IniHash, System>>& out) noexcept {
+    auto const file = MemoryFile::from_memory(data, size);
+    Reader reader = { file };
+    Header header;
+    if(!file.read(header) || memcmp(header.magic, magic, sizeof(magic))) {
+        return -1;
+    }
+    if(header.version != version) {
+        return -2;
+    }
+    // every entry takes its hash and at least one byte
+    out.reserve(out.size() + std::min<size_t>(header.count,
+                                              reader.left() / (sizeof(uint32_t) + min_size<System>::value)));
+    for(uint32_t i = 0; i < header.count; i++) {
+        uint32_t hash;
+        if(!file.read(hash)) {
+            return -3;
+        }
+        auto& entry = out.emplace_back(hash, System{});
+        if(!transfer(reader, entry.second)) {
+            out.pop_back();
+            return -3;
+        }
+    }
+    return 0;
+}
+
+}
@@ -0,0 +1,55 @@
+#ifndef PARTICLE_SNAPSHOT_H
+#define PARTICLE_SNAPSHOT_H
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "system.h"
+
+namespace RitoParticle {
+    // Parsed Systems stored as one flat stream without pointers or offsets,
+    // read back in a single pass. Plain structs are copied in host layout,
+    // padding included, so a snapshot only reads back on the platform and
+    // build that wrote it.
+    // Ramps are rebuilt on read instead of stored.
+    namespace Snapshot {
+        // bump on any change to the parsed structs
+        inline constexpr uint32_t version = 1;
+
+        struct Header {
+            char magic[4];
+            uint32_t version;
+            uint32_t count;
+        };
+
+        using Entry = std::pair<IniHash, System const*>;
+
+        void write(std::vector<uint8_t>& out, Entry const* entries, size_t count) noexcept;
+
+        // Memory taken by the PVar curves of a set of Systems
+        struct CurveReport {
+            size_t pvars = 0;
+            // PVars with keyframes that point to a ramp
+            size_t curves = 0;
+            // ramps left after CurvePool merged equal ones
+            size_t unique = 0;
+            // a ramp embedded in every PVar, the layout before CurvePool
+            size_t inline_bytes = 0;
+            // unique ramps plus a handle per PVar
+            size_t pooled_bytes = 0;
+            // a BakedPVar per PVar with keyframes, float ones included
+            size_t baked_bytes = 0;
+            // BakedPVars that missed max_error
+            size_t missed = 0;
+        };
+
+        // Walks the same fields write() does, baking curves with max_error
+        CurveReport measure_curves(Entry const* entries, size_t count,
+                                   float max_error) noexcept;
+
+        // Returns -1 on bad magic, -2 on other version, -3 on truncated data
+        int read(uint8_t const* data, size_t size,
+                 std::vector<std::pair<IniHash, System>>& out) noexcept;
+    }
+}
+
+#endif // PARTICLE_SNAPSHOT_H
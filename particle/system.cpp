@@ -1,84 +1,108 @@
 #include "system.h"
+#include "keys.h"
+
+namespace {
+using RitoParticle::Key::max_group_parts;
+
+template<size_t...I>
+inline std::array<IniHash, sizeof...(I)>
+group_part_names(IniHash const h, std::index_sequence<I...>) noexcept {
+    return {{ (h * RitoParticle::Key::GroupPart[I].name)... }};
+}
+
+// Looks up every GroupPart name at once, parts end at the first missing one
+inline size_t read_part_names(Ini const& ini, IniHash const h, std::string* names) noexcept {
+    auto const keys = group_part_names(h, std::make_index_sequence<max_group_parts>{});
+    IniValue values[max_group_parts];
+    ini.get_batch(keys.data(), keys.size(), values);
+    size_t count = 0;
+    while(count < keys.size() && ini_get(values[count], names[count])) {
+        count++;
+    }
+    return count;
+}
+}
+
+size_t RitoParticle::System::count_parts(Ini const& ini) noexcept {
+    // any value reads as a name, presence is enough
+    IniHash const h = "System";
+    size_t count = 0;
+    while(count < max_group_parts && ini.contains(h * Key::GroupPart[count].name)) {
+        count++;
+    }
+    return count;
+}
 
 bool RitoParticle::System::load(const Ini &ini) noexcept {
     IniHash const h = "System";
-    // no real limit is enforced but sprintf's would stop working at some point
-    for(size_t i = 1; i < 100; i++) {
-        char buffer[64];
-        sprintf_s(buffer, sizeof(buffer), "GroupPart%u", i);
-        if(auto name = ini[h * buffer].as<std::string>(); name) {
-            sprintf_s(buffer, sizeof(buffer), "GroupPart%uImportance", i);
-            auto const importancestr = ini[h * buffer].as_or<std::string>();
-            Importance importance = Importance::High;
-            if(importancestr == "High") {
-                importance = Importance::High;
-            } else if(importancestr == "Medium") {
-                importance = Importance::Normal;
-            } else if(importancestr == "Low") {
-                importance = Importance::Low;
-            } else {
-                importance = Importance::NotWhenHigh;
-            }
-
-            auto& part = parts.emplace_back();
-            part.importance = importance;
-
-            sprintf_s(buffer, sizeof(buffer), "GroupPart%uType", i);
-            auto const type = ini[h * buffer].as_or<std::string>("Complex");
-
-            if(type == "Simple") {
-                auto& definition = part.definition.emplace<SimpleParticle>();
-                definition.load(ini, name.value());
-            } else {
-                auto& definition = part.definition.emplace<ComplexEmitter>();
-                definition.load(ini, name.value());
-
-                sprintf_s(buffer, sizeof(buffer), "Override-Offset%u", i);
-                part.translation = ini[h * buffer].as_or<Vec3>();
-
-                sprintf_s(buffer, sizeof(buffer), "Override-Rotation%u", i);
-                part.rotation = ini[h * buffer].as_or<Vec3>();
-
-                sprintf_s(buffer, sizeof(buffer), "Override-Scale%u", i);
-                part.scale = ini[h * buffer].as_or<Vec3>(1.f, 1.f, 1.f);
-            }
+    std::string names[max_group_parts];
+    auto const count = read_part_names(ini, h, names);
+    parts.reserve(parts.size() + count);
+    for(size_t i = 0; i < count; i++) {
+        auto const& keys = Key::GroupPart[i];
+        auto const& name = names[i];
+        auto const importancestr = ini[h * keys.importance].as_or<std::string>();
+        Importance importance = Importance::High;
+        if(importancestr == "High") {
+            importance = Importance::High;
+        } else if(importancestr == "Medium") {
+            importance = Importance::Normal;
+        } else if(importancestr == "Low") {
+            importance = Importance::Low;
+        } else {
+            importance = Importance::NotWhenHigh;
+        }
+
+        auto& part = parts.emplace_back();
+        part.importance = importance;
+
+        auto const type = ini[h * keys.type].as_or<std::string>("Complex");
+
+        if(type == "Simple") {
+            auto& definition = part.definition.emplace<SimpleParticle>();
+            definition.load(ini, name);
         } else {
-            break;
+            auto& definition = part.definition.emplace<ComplexEmitter>();
+            definition.load(ini, name);
+
+            part.translation = ini[h * keys.offset].as_or<Vec3>();
+            part.rotation = ini[h * keys.rotation].as_or<Vec3>();
+            part.scale = ini[h * keys.scale].as_or<Vec3>(1.f, 1.f, 1.f);
         }
     }
 
-    visibilityRadius = ini[h *  "group-vis"].as_or<float>(250.0f);
+    visibilityRadius = ini[h * Key::group_vis].as_or<float>(250.0f);
 
-    soundOnCreateDefault = ini[h * "SoundOnCreate"].as_or<std::string>();
+    soundOnCreateDefault = ini[h * Key::SoundOnCreate].as_or<std::string>();
 
-    soundPersistentDefault = ini[h * "SoundPersistent"].as_or<std::string>();
+    soundPersistentDefault = ini[h * Key::SoundPersistent].as_or<std::string>();
 
-    if(ini[h * "SimulateWhileOffScreen"].as_or<bool>()) {
+    if(ini[h * Key::SimulateWhileOffScreen].as_or<bool>()) {
       flags |= 1u;
     }
-    if(ini[h * "PersistThruDeath"].as_or<bool>()) {
+    if(ini[h * Key::PersistThruDeath].as_or<bool>()) {
       flags |= 2u;
     }
-    if(ini[h * "SimulateOncePerFrame"].as_or<bool>()) {
+    if(ini[h * Key::SimulateOncePerFrame].as_or<bool>()) {
       flags |= 4u;
     }
-    if(ini[h * "SoundEndsOnEmitterEnd"].as_or<bool>()) {
+    if(ini[h * Key::SoundEndsOnEmitterEnd].as_or<bool>()) {
       flags |= 0x08;
     }
-    if(ini[h * "SoundsPlayWhileOffScreen"].as_or<bool>()) {
+    if(ini[h * Key::SoundsPlayWhileOffScreen].as_or<bool>()) {
       flags |= 0x10u;
     }
-    if(ini[h *  "SimulateEveryFrame"].as_or<bool>()) {
+    if(ini[h * Key::SimulateEveryFrame].as_or<bool>()) {
       flags |= 0x20u;
     }
-    if(ini[h * "KeepOrientationAfterSpellCast"].as_or<bool>(true)) {
+    if(ini[h * Key::KeepOrientationAfterSpellCast].as_or<bool>(true)) {
       flags |= 0x40u;
     }
 
-    buildUpTime = ini[h * "build-up-time"].as_or<float>();
+    buildUpTime = ini[h * Key::build_up_time].as_or<float>();
 
     materialOverrideList.load(ini, h);
 
-    selfIllumination = ini[h * "SelfIllumination"].as_or<float>(-1.0f);
+    selfIllumination = ini[h * Key::SelfIllumination].as_or<float>(-1.0f);
     return true;
 }
@@ -30,6 +30,9 @@ namespace RitoParticle {
         Importance importance;
 
         bool load(Ini const& ini) noexcept;
+
+        // Number of GroupPart entries load() would read
+        static size_t count_parts(Ini const& ini) noexcept;
     };
 }
 
@@ -0,0 +1,33 @@
+#ifndef PATHS_HPP
+#define PATHS_HPP
+#include <filesystem>
+#include <string>
+#include <system_error>
+
+inline bool is_troybin(std::filesystem::path const& path) noexcept {
+    auto ext = path.extension().string();
+    for(auto& c: ext) {
+        c = static_cast<char>(c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c);
+    }
+    return ext == ".troybin";
+}
+
+// Calls fn(path) for every regular file under root. Stops at the first
+// error and returns it, a range-for would throw from operator++ instead.
+template<typename Fn>
+std::error_code for_each_file(std::filesystem::path const& root, Fn&& fn) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    for(fs::recursive_directory_iterator it(root, ec), end; !ec && it != end; it.increment(ec)) {
+        auto const regular = it->is_regular_file(ec);
+        if(ec) {
+            break;
+        }
+        if(regular) {
+            fn(it->path());
+        }
+    }
+    return ec;
+}
+
+#endif // PATHS_HPP
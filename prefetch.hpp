@@ -0,0 +1,83 @@
+#ifndef PREFETCH_HPP
+#define PREFETCH_HPP
+#include "file.hpp"
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+
+// Reads a batch of files concurrently into pooled buffers,
+// parse them afterwards through MemoryFile::from_memory
+struct Prefetcher {
+    struct Entry {
+        std::string path;
+        std::vector<uint8_t> data;
+        bool good;
+    };
+
+    std::vector<Entry> entries;
+    std::vector<std::vector<uint8_t>> pool;
+
+    // Returns number of files that failed to read
+    size_t load(std::vector<std::string> const& paths, size_t threads = 0) {
+        recycle();
+        entries.reserve(paths.size());
+        for(auto const& path: paths) {
+            auto& entry = entries.emplace_back();
+            entry.path = path;
+            entry.good = false;
+            if(!pool.empty()) {
+                entry.data = std::move(pool.back());
+                pool.pop_back();
+            }
+        }
+
+        if(!threads) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        threads = std::min(threads, entries.size());
+
+        std::atomic<size_t> next = 0;
+        std::atomic<size_t> failed = 0;
+        auto const worker = [this, &next, &failed] {
+            for(size_t i = next++; i < entries.size(); i = next++) {
+                auto& entry = entries[i];
+                // whole file goes in one read, no point in read-ahead
+                auto const file = StdioFile::readb(entry.path.c_str(), 0);
+                if(file && file->read(entry.data, file->end)) {
+                    entry.good = true;
+                } else {
+                    failed++;
+                }
+            }
+        };
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        for(size_t t = 0; t < threads; t++) {
+            workers.emplace_back(worker);
+        }
+        for(auto& w: workers) {
+            w.join();
+        }
+        return failed;
+    }
+
+    inline std::optional<MemoryFile> open(size_t index) const noexcept {
+        if(index >= entries.size() || !entries[index].good) {
+            return std::nullopt;
+        }
+        auto const& data = entries[index].data;
+        return MemoryFile::from_memory(data.data(), data.size());
+    }
+
+    // Hands buffers back to the pool, any File from open() is invalidated
+    inline void recycle() {
+        for(auto& entry: entries) {
+            entry.data.clear();
+            pool.push_back(std::move(entry.data));
+        }
+        entries.clear();
+    }
+};
+
+#endif // PREFETCH_HPP
@@ -23,27 +23,16 @@ struct RitoANM {
     int32_t frameRate;
     std::vector<Track> tracks{};
 
+    template<typename File>
     int read_v1(File const& file) noexcept {
-        if(!file.read(skeletonID)) {
+        if(!file.read_struct_batch(skeletonID, numTracks, numFrames, frameRate)) {
             return -3;
         }
-        if(!file.read(numTracks)) {
-            return -4;
-        }
-        if(!file.read(numFrames)) {
-            return -5;
-        }
-        if(!file.read(frameRate)) {
-            return -6;
-        }
         for(int32_t t = 0; t < numTracks; t++) {
             auto& track = tracks.emplace_back();
-            if(!file.read(track.name)) {
+            if(!file.read_struct_batch(track.name, track.flags)) {
                 return -7;
             }
-            if(!file.read(track.flags)) {
-                return -8;
-            }
             if(!file.read(track.frames, static_cast<size_t>(numFrames))) {
                 return -9;
             }
@@ -52,10 +41,11 @@ struct RitoANM {
         return 0;
     }
 
+    template<typename File>
     int load(File const& file) noexcept {
         std::array<char, 8> magic;
         uint32_t version;
-        if(!file.read(magic) || !file.read(version)) {
+        if(!file.read_struct_batch(magic, version)) {
             return -1;
         }
         if(magic != std::array{'r', '3', 'd', '2', 'a', 'n', 'm', 'd'} || version != 3 ) {
@@ -5,6 +5,7 @@
 #include "ritomath.hpp"
 #include <variant>
 #include <algorithm>
+#include <memory>
 
 struct RitoNVR {
     struct Material {
@@ -110,12 +111,31 @@ struct RitoNVR {
     };
 
     std::vector<Material> materials;
-    std::vector<std::vector<uint8_t>> vertexBuffers;
-    std::vector<std::vector<uint32_t>> indexBuffers;
+    std::vector<FileArray<uint8_t>> vertexBuffers;
+    std::vector<FileArray<uint32_t>> indexBuffers;
     std::vector<Mesh> meshes;
     std::vector<Node> nodes;
+    // set when vertex and index buffers view the file in place
+    std::shared_ptr<MemoryFile const> backing;
 
+    // Copies everything, file is not needed after loading
+    template<typename File>
     int load(File const& file) noexcept {
+        backing = {};
+        return load(file, false);
+    }
+
+    // Vertex and 32 bit index buffers view the mapping, it is kept alive with this map
+    int load(std::shared_ptr<MemoryFile const> file) noexcept {
+        if(!file) {
+            return -1;
+        }
+        backing = std::move(file);
+        return load(*backing, true);
+    }
+
+    template<typename File>
+    int load(File const& file, bool in_place) noexcept {
         struct Header {
             std::array<char, 4> magic;
             uint32_t version;
@@ -154,9 +174,13 @@ struct RitoNVR {
                 return  -6;
             }
             auto& buffer = vertexBuffers.emplace_back();
-            if(!file.read(buffer, size)) {
+            if(!file.read(buffer, size, in_place)) {
                 return  -7;
             }
+            // BufferRange reads vertices straight out of the buffer
+            if(reinterpret_cast<uintptr_t>(buffer.data()) % alignof(float)) {
+                buffer.assign({ buffer.begin(), buffer.end() });
+            }
         }
 
         for(uint32_t i = 0; i < header.indexBufferCount; i++) {
@@ -169,14 +193,16 @@ struct RitoNVR {
                 return -8;
             }
             if (format == 0x65) {
-                std::vector<uint16_t> buffer{};
-                if(!file.read(buffer, size / sizeof(uint16_t))) {
+                // widened to 32 bit, always a copy
+                Span<uint16_t> buffer{};
+                std::vector<uint16_t> storage{};
+                if(!file.read_view(buffer, storage, size / sizeof(uint16_t))) {
                     return -10;
                 }
-                indexBuffers.emplace_back(buffer.begin(), buffer.end());
+                indexBuffers.emplace_back().assign({ buffer.begin(), buffer.end() });
             } else if(format == 0x66) {
                 auto& buffer = indexBuffers.emplace_back();
-                if(!file.read(buffer, size / sizeof(uint32_t))) {
+                if(!file.read(buffer, size / sizeof(uint32_t), in_place)) {
                     return -11;
                 }
             } else {
@@ -245,7 +271,7 @@ struct RitoNVR {
       T const* const startp;
       T const* const endp;
       BufferRange() = default;
-      BufferRange(std::vector<uint8_t> const& vec, uint32_t first, uint32_t count) noexcept
+      BufferRange(Span<uint8_t> const& vec, uint32_t first, uint32_t count) noexcept
         : startp(reinterpret_cast<T const*>(vec.data()) + first),
           endp(reinterpret_cast<T const*>(vec.data()) + first + count)
       { }
@@ -19,6 +19,7 @@ namespace RitoResource {
         };
         std::vector<Channel> channels;
 
+        template<typename File>
         int load_v4(File const& file) {
             struct TickSaved {
                 uint32_t boneHash;
@@ -43,10 +44,12 @@ namespace RitoResource {
                 uint32_t tickDataOffset;
                 uint32_t extBuffer[3];
             } v4 {};
-            std::vector<uint8_t> data{};
+            Span<uint8_t> data{};
+            std::vector<uint8_t> storage{};
             file.read(v4);
-            data.resize(v4.resourceSize - sizeof(v4));
-            file.read(data.data(), data.size());
+            if(!file.read_view(data, storage, v4.resourceSize - sizeof(v4))) {
+                return -1;
+            }
 
             auto const vecStartAddr = data.data() + v4.vectorPaletteOffset - sizeof(v4);
             auto const vecStart = reinterpret_cast<Vec3 const*>(vecStartAddr);
@@ -75,6 +78,7 @@ namespace RitoResource {
             return 0;
         }
 
+        template<typename File>
         int load(File const& file) {
             struct {
                 std::array<char, 8> magic;
@@ -111,6 +115,7 @@ namespace RitoResource {
         std::string assetName;
         std::vector<uint32_t> shaderBones;
         std::vector<Joint> joints;
+        template<typename File>
         int load(File const& file) {
             struct V0{
                 uint32_t resourceSize;
@@ -147,9 +152,11 @@ namespace RitoResource {
             file.read(resourceSize);
             file.seek_cur(-sizeof(resourceSize));
 
-            std::vector<uint8_t> data;
-            data.resize(resourceSize);
-            file.read(data.data(), data.size());
+            Span<uint8_t> data{};
+            std::vector<uint8_t> storage{};
+            if(!file.read_view(data, storage, resourceSize)) {
+                return -1;
+            }
 
             auto const& v0 = *reinterpret_cast<V0 const*>(data.data());
             auto const jointArrAddr = data.data() + v0.jointArrOffset;
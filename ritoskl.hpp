@@ -3,6 +3,7 @@
 #include "file.hpp"
 #include "types.hpp"
 #include "ritomath.hpp"
+#include <memory>
 
 struct RitoSKL {
     struct Bone {
@@ -49,13 +50,32 @@ struct RitoSKL {
     uint32_t numBones;
     std::vector<Bone> bones;
     uint32_t numShaderBones;
-    std::vector<uint32_t> shaderBones;
+    FileArray<uint32_t> shaderBones;
+    // set when shaderBones views the file in place
+    std::shared_ptr<MemoryFile const> backing;
 
+    // Copies everything, file is not needed after loading
+    template<typename File>
     int load(File const& file) noexcept {
+        backing = {};
+        return load(file, false);
+    }
+
+    // Shader bones view the mapping, it is kept alive with this skeleton
+    int load(std::shared_ptr<MemoryFile const> file) noexcept {
+        if(!file) {
+            return -1;
+        }
+        backing = std::move(file);
+        return load(*backing, true);
+    }
+
+    template<typename File>
+    int load(File const& file, bool in_place) noexcept {
         std::array<char, 8> magic;
         uint32_t version;
 
-        if(!file.read(magic) || !file.read(version)) {
+        if(!file.read_struct_batch(magic, version)) {
             return -1;
         }
         if(magic != std::array{'r', '3', 'd', '2', 's', 'k', 'l', 't'} ||
@@ -69,15 +89,17 @@ struct RitoSKL {
         if(!file.read(numBones)) {
             return -5;
         }
-        std::vector<Bone::Saved> savedBones;
-        if(!file.read(savedBones, numBones)) {
+        // only needed while converting, always viewed when possible
+        Span<Bone::Saved> savedBones;
+        std::vector<Bone::Saved> savedStorage;
+        if(!file.read_view(savedBones, savedStorage, numBones)) {
             return -6;
         }
         if(version == 2) {
             if(!file.read(numShaderBones)) {
                 return -7;
             }
-            if(!file.read(shaderBones, numShaderBones)) {
+            if(!file.read(shaderBones, numShaderBones, in_place)) {
                 return -8;
             }
         }
@@ -5,6 +5,7 @@
 #include "ritomath.hpp"
 #include <vector>
 #include <variant>
+#include <memory>
 
 struct RitoSKN {
     struct SubMesh {
@@ -41,18 +42,37 @@ struct RitoSKN {
     };
 
     std::vector<SubMesh> submeshes;
-    std::vector<uint16_t> indexData;
+    FileArray<uint16_t> indexData;
     uint32_t flags;
     Box3D boundingBox;
     Sphere boundingSphere;
-    std::variant<std::vector<VertexBasic>, std::vector<VertexWithColor>> vertexData;
+    std::variant<FileArray<VertexBasic>, FileArray<VertexWithColor>> vertexData;
     std::array<float, 3> pivotPoint;
+    // set when indexData and vertexData view the file in place
+    std::shared_ptr<MemoryFile const> backing;
 
+    // Copies everything, file is not needed after loading
+    template<typename File>
     int load(File const& file) noexcept {
+        backing = {};
+        return load(file, false);
+    }
+
+    // Index and vertex data view the mapping, it is kept alive with this mesh
+    int load(std::shared_ptr<MemoryFile const> file) noexcept {
+        if(!file) {
+            return -1;
+        }
+        backing = std::move(file);
+        return load(*backing, true);
+    }
+
+    template<typename File>
+    int load(File const& file, bool in_place) noexcept {
         uint32_t magic;
         uint32_t version;
 
-        if(!file.read(magic) || !file.read(version)) {
+        if(!file.read_struct_batch(magic, version)) {
             return -1;
         }
         if(magic != 0x00112233) {
@@ -103,7 +123,7 @@ struct RitoSKN {
             boundingSphere = {};
         }
 
-        if(!file.read(indexData, geometry.old.numIndices)) {
+        if(!file.read(indexData, geometry.old.numIndices, in_place)) {
             return -40;
         }
 
@@ -111,16 +131,16 @@ struct RitoSKN {
             if(geometry.vertexSize != sizeof(VertexBasic)) {
                 return -50;
             }
-            auto& vertex = vertexData.emplace<std::vector<VertexBasic>>();
-            if(!file.read(vertex, geometry.old.numVertices)) {
+            auto& vertex = vertexData.emplace<FileArray<VertexBasic>>();
+            if(!file.read(vertex, geometry.old.numVertices, in_place)) {
                 return -51;
             }
         } else if(geometry.vertexType == 1) {
             if(geometry.vertexSize != sizeof(VertexWithColor)) {
                 return -60;
             }
-            auto& vertex = vertexData.emplace<std::vector<VertexWithColor>>();
-            if(!file.read(vertex, geometry.old.numVertices)) {
+            auto& vertex = vertexData.emplace<FileArray<VertexWithColor>>();
+            if(!file.read(vertex, geometry.old.numVertices, in_place)) {
                 return -61;
             }
         } else {